@@ -19,20 +19,23 @@
  * degenerate symbols.
  * It must begin and end with a seed; the seed itself can be empty.
  * - the nuber of degenerate symbols = number of seeds - 1
- * The degenerate symbol is represented as a boolean vector of size equal to
- * alphabet. 0 if corresponding letter is absent else 1.
- * All the degenefrate symbols are collected together as a vector; all the seeds
- * are collected together as a vector.
+ * The degenerate symbol is represented as a bitmask with one bit for each
+ * letter of the alphabet. 0 if corresponding letter is absent else 1.
+ * All the degenefrate symbols are collected together in one flat vector of
+ * fixed-width masks. The string seen as a sequence is stored in one flat
+ * vector: letters of the seeds as they are and, in place of each degenerate
+ * symbol, a marker holding the index of that symbol.
  * It also contains the indices at which the degenerate symbol appears in the
- * string when seen as a sequence.
+ * string when seen as a sequence, and those at which each seed starts.
  *
  * Provides methods for the following:
- * - Adding seed.
+ * - Adding seed (at once, or by starting it and appending its letters).
  * - Adding a degenerate symbol.
- * - Getting a reference to the seeds, the total number of the seeds, the
+ * - Getting a reference to the sequence, the total number of the seeds, the
  * total size of the string seen as a sequence, and the size of the alphabet
  * used.
- * - Checks whether the two symbols at the given indices match (degeneate
+ * - Mapping a position of the sequence to the degenerate symbol at it.
+ * - Checks whether the two symbols at the given positions match (degeneate
  * match).
  */
 
@@ -55,24 +58,61 @@ public:
    */
   Degenerate_string(const UINT as);
 
-  /** @brief adds the given seed in the collection and changes the length of the
-   *sequence correspondingly
+  /** @brief appends the letters of the given seed to the sequence and changes
+   *the length of the sequence correspondingly
    * @see SEED
    *
    **/
   void add_seed(SEED const &seed);
 
+  /** @brief starts a seed at the end of the sequence; its letters are then
+   *appended by append_letters
+   *
+   **/
+  void start_seed() { _seed_offsets.push_back(_length); }
+
+  /** @brief appends the given number of letters to the current seed and
+   *returns a pointer to them, to be written in place (e.g. by the parser)
+   *
+   **/
+  ENCODED_CHAR *append_letters(const UINT count) {
+    _symbols.resize(_length + count);
+    _length += count;
+    return _symbols.data() + _length - count;
+  }
+
+  /** @brief drops the given number of letters from the end of the current
+   *seed (e.g. appended beyond a run of letters)
+   *
+   **/
+  void drop_letters(const UINT count) {
+    _length -= count;
+    _symbols.resize(_length);
+  }
+
+  /** @brief reserves room for the given number of symbols of the sequence
+   *
+   **/
+  void reserve(const UINT size) { _symbols.reserve(size); }
+
   /** @brief adds the given degenerate symbol in the collection and increases
    *the length of the sequence by 1.
    * It also updates the index of the symbol when the string is seens as the
    *sequence.
    * @param deg reference to the vector containing the letters present in the
    *symbol
-   * @see DEGENERATE_SYMBOL
+   * @see DEGENERATE_SYMBOLS
    *
    **/
   void add_degenerate_symbol(std::vector<ENCODED_CHAR> const &deg);
 
+  /** @brief adds the degenerate symbol of the given letters (as a mask of
+   *the letters below cMask_bits) and increases the length of the sequence by
+   *1
+   *
+   **/
+  void add_degenerate_symbol(const SYMBOL_MASK mask);
+
   /** @brief returns the number of the seeds in the collection
    *
    **/
@@ -88,16 +128,39 @@ public:
    **/
   UINT get_alphabet_size() const;
 
-  /** @brief returns a reference to the collection of the seeds
+  /** @brief returns a reference to the string seen as a sequence
+   * An entry is either a letter or cDegenerate_marker combined with the index
+   *of the degenerate symbol at that position
+   * @see cDegenerate_marker
    *
    **/
-  const SEEDS &get_seeds() const;
+  const std::vector<ENCODED_CHAR> &get_symbols() const;
+
+  /** @brief returns a reference to the vector of positions at which each seed
+    *starts in the string when seen as a sequence
+   *
+   **/
+  const std::vector<UINT> &get_seed_offsets() const;
 
   /** @brief returns a reference to the collection of the degenerate symbols
+   * The mask of the symbol i occupies the words [i * w, (i + 1) * w), where w
+   * is given by get_mask_words()
    *
    **/
   const DEGENERATE_SYMBOLS &get_degenerate_symbols() const;
 
+  /** @brief returns the number of words in the mask of one degenerate symbol
+   *
+   **/
+  UINT get_mask_words() const;
+
+  /** @brief returns whether the given letter is present in the degenerate
+   *symbol at the given index
+   * Assumes the index and the letter to be valid.
+   *
+   **/
+  bool has_letter(UINT symb, ENCODED_CHAR letter) const;
+
   /** @brief returns a reference to the vector of indices of the degenerate
     *symbols in the string when seen as a sequence
    *
@@ -106,25 +169,40 @@ public:
 
   /** @brief returns the last symbol in the seed at the given index
    * Assumes the index is valid(i.e. it is in a seed) and that seed is non-empty
-   * @see Index
    *
    **/
   ENCODED_CHAR get_seed_lastletter(UINT ind) const;
 
-  /** @brief returns whether the symbol at the given indices match (degenerate)
+  /** @brief returns whether there is a degenerate symbol at the given position
+   *
+   **/
+  bool is_degenerate(UINT pos) const {
+    return (_symbols[pos] & cDegenerate_marker) != 0;
+  }
+
+  /** @brief returns the index of the degenerate symbol at the given position
+   * Assumes there is a degenerate symbol at the position.
+   *
+   **/
+  UINT get_symbol_index(UINT pos) const {
+    return _symbols[pos] & ~cDegenerate_marker;
+  }
+
+  /** @brief returns whether the symbols at the given positions match
    * The match is degnerate.
-   * Assumes Indexes to be valid.
-   * @see Index
+   * Assumes positions to be valid.
    *
    **/
-  bool is_match(INDEX ind1, INDEX ind2) const;
+  bool is_match(UINT pos1, UINT pos2) const;
 
   //////////////////////// private ////////////////////////
 private:
   const UINT _cAlphabet_size; //< Size of the alphabet
-  SEEDS _seeds;               //< collection of all the seeds
-                              /** Vector of the degenerate symbols
-                               * A degenerate symbol has length 1 more than the alphabet size as the letters
+  const UINT _cMask_words;    //< Words in the mask of one degenerate symbol
+  std::vector<ENCODED_CHAR> _symbols; //< the string seen as a sequence
+  std::vector<UINT> _seed_offsets;    //< starting position of each seed
+                              /** Masks of the degenerate symbols
+                               * A mask has 1 bit more than the alphabet size as the letters
                                * are being mapped from 1 to alphabet-size.
                               */
   DEGENERATE_SYMBOLS _degenerate_symbols;
@@ -0,0 +1,225 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Gz_stream.hpp
+ * @brief Defines the classes Gz_istream and Gz_ostream.
+ * A Gz_istream reads a file compressed with gzip (or BGZF, a series of gzip
+ * members), or an uncompressed one as it is; a Gz_ostream writes a file compressed in BGZF (readable by
+ * gzip too), or an uncompressed one. The (de)compression and the writes run
+ * on a helper thread, overlapping with the parsing, the calculation and the
+ * formatting of the output: chunks of data are passed between the stream
+ * and its helper through a bounded queue (Chunk_queue).
+ */
+
+#ifndef GZ_STREAM_HPP
+#define GZ_STREAM_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <zlib.h>
+
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+/** Class Chunk_queue
+ * A bounded queue of chunks of data between a producer and a consumer
+ * thread.
+ */
+class Chunk_queue {
+
+public:
+  /** @brief Constructor for Class Chunk_queue
+   * @param capacity maximum number of chunks in the queue
+   *
+   **/
+  Chunk_queue(const UINT capacity) : _capacity(capacity) {}
+
+  /** @brief adds the given chunk, waiting while the queue is full
+   * @return false if the queue is closed (the chunk is dropped)
+   *
+   **/
+  bool push(std::string &chunk);
+
+  /** @brief takes the next chunk, waiting while the queue is empty
+   * @return false if the queue is empty and closed
+   *
+   **/
+  bool pop(std::string &chunk);
+
+  /** @brief closes the queue: no chunk is added after it; the ones in it are
+   *still taken
+   *
+   **/
+  void close();
+
+  //////////////////////// private ////////////////////////
+private:
+  const UINT _capacity;            //< maximum number of chunks
+  std::mutex _mutex;               //< guards the state below
+  std::condition_variable _pushed; //< a chunk is added (or closed)
+  std::condition_variable _popped; //< a chunk is taken (or closed)
+  std::deque<std::string> _chunks; //< chunks in the order of the data
+  bool _closed = false;            //< no more chunks are added
+};
+
+/** Class Gz_istreambuf
+ * Buffer of a Gz_istream: its helper thread decompresses the file into
+ * chunks; the buffer reads them in turn.
+ */
+class Gz_istreambuf : public std::streambuf {
+
+public:
+  /** @brief Constructor for Class Gz_istreambuf: starts decompressing the
+   *given (opened) file
+   *
+   **/
+  Gz_istreambuf(gzFile file);
+  ~Gz_istreambuf();
+
+protected:
+  int_type underflow() override;
+
+  //////////////////////// private ////////////////////////
+private:
+  gzFile _file;         //< file being decompressed
+  Chunk_queue _queue;   //< chunks decompressed but not yet read
+  std::string _chunk;   //< chunk being read
+  std::thread _helper;  //< decompresses the file
+
+  /** @brief decompresses the file chunk by chunk until its end
+   *
+   **/
+  void decompress();
+};
+
+/** Class Gz_ostreambuf
+ * Buffer of a Gz_ostream: the written data is handed over in chunks to its
+ * helper thread, which compresses them into BGZF blocks (if so) and writes
+ * them.
+ */
+class Gz_ostreambuf : public std::streambuf {
+
+public:
+  /** @brief Constructor for Class Gz_ostreambuf: starts the helper writing
+   *to the given (opened) file, compressed or not
+   *
+   **/
+  Gz_ostreambuf(std::FILE *file, const bool compressed);
+  ~Gz_ostreambuf();
+
+  /** @brief hands over the remaining data, waits for all of it to be written
+   *and closes the file (with the end-of-file block of BGZF, if compressed)
+   * @return execution status // SUCCESS if all the data is written,
+   *otherwise ERR_FILE_OPEN
+   *
+   **/
+  ReturnStatus close();
+
+protected:
+  int_type overflow(int_type c) override;
+  int sync() override;
+
+  //////////////////////// private ////////////////////////
+private:
+  std::FILE *_file;     //< file being written
+  Chunk_queue _queue;   //< chunks written but not yet compressed
+  std::string _chunk;   //< chunk being written
+  bool _error = false;  //< the helper could not write
+  const bool _compressed; //< the chunks are compressed (or written as such)
+  std::thread _helper;  //< compresses and writes the chunks
+
+  /** @brief hands the data written so far over to the helper
+   *
+   **/
+  void hand_over();
+
+  /** @brief compresses (if so) and writes the chunks until the queue is
+   *closed
+   *
+   **/
+  void compress();
+};
+
+/** Class Gz_istream
+ * An input stream of a file compressed with gzip or BGZF.
+ */
+class Gz_istream : public std::istream {
+
+public:
+  Gz_istream() : std::istream(nullptr) {}
+
+  /** @brief opens the given file and starts decompressing it
+   * @return execution status // SUCCESS if the file is opened, otherwise
+   *ERR_FILE_OPEN
+   *
+   **/
+  ReturnStatus open(const std::string &filename);
+
+  /** @brief returns whether the data in the given range (e.g. a mapped
+   *file) is compressed with gzip (or BGZF), by its first bytes
+   *
+   **/
+  static bool is_compressed(const char *begin, const char *end);
+
+  //////////////////////// private ////////////////////////
+private:
+  std::unique_ptr<Gz_istreambuf> _buf; //< buffer of the stream
+};
+
+/** Class Gz_ostream
+ * An output stream of a file compressed in BGZF, or of an uncompressed file
+ * written on a helper thread all the same.
+ */
+class Gz_ostream : public std::ostream {
+
+public:
+  Gz_ostream() : std::ostream(nullptr) {}
+  ~Gz_ostream() { close(); }
+
+  /** @brief creates the given file and starts the helper writing to it
+   * @param filename name of the file
+   * @param compressed whether the file is compressed (in BGZF)
+   * @return execution status // SUCCESS if the file is created, otherwise
+   *ERR_FILE_OPEN
+   *
+   **/
+  ReturnStatus open(const std::string &filename, const bool compressed = true);
+
+  /** @brief writes the remaining data and closes the file
+   * @return execution status // SUCCESS if all the data is written,
+   *otherwise ERR_FILE_OPEN
+   *
+   **/
+  ReturnStatus close();
+
+  /** @brief returns whether the output of the given name is to be
+   *compressed (it ends in ".gz" or ".bgz")
+   *
+   **/
+  static bool is_compressed_name(const std::string &filename);
+
+  //////////////////////// private ////////////////////////
+private:
+  std::unique_ptr<Gz_ostreambuf> _buf; //< buffer of the stream
+};
+
+} // end namespace
+#endif
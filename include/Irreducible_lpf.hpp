@@ -0,0 +1,138 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Irreducible_lpf.hpp
+ * @brief Defines the class Irreducible_lpf, a compressed LPF-array.
+ * An LPF-array is mostly made of runs l, l-1, l-2, ...: a factor at i
+ * followed by the same one shortened at i+1. A position i is irreducible if
+ * LPF[i] != LPF[i-1] - 1 (the first one always is); only the irreducible
+ * positions (in an sdsl::sd_vector, Elias-Fano coded) and their values (in a
+ * bit-compressed vector) are stored. For any position i, with p the last
+ * irreducible position up to i (by rank and select on the sd_vector),
+ * LPF[i] = LPF[p] - (i - p).
+ */
+
+#ifndef IRREDUCIBLE_LPF_HPP
+#define IRREDUCIBLE_LPF_HPP
+
+#include <sdsl/int_vector.hpp>
+#include <sdsl/sd_vector.hpp>
+
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+/** Class Irreducible_lpf
+ * An LPF-array stored by its irreducible positions; it is read-only once
+ * built.
+ */
+class Irreducible_lpf {
+
+public:
+  /** @brief Constructor for Class Irreducible_lpf: an empty array
+   *
+   **/
+  Irreducible_lpf() { bind(); }
+
+  /** @brief Constructor for Class Irreducible_lpf: encodes the given
+   *LPF-array
+   *
+   **/
+  explicit Irreducible_lpf(const std::vector<UINT> &lpf);
+
+  /** @brief Constructor for Class Irreducible_lpf: encodes the given
+   *LPF-array whose irreducible positions are known (in increasing order)
+   *
+   **/
+  Irreducible_lpf(const std::vector<UINT> &lpf,
+                  const std::vector<UINT> &positions);
+
+  Irreducible_lpf(const Irreducible_lpf &other);
+  Irreducible_lpf &operator=(const Irreducible_lpf &other);
+  /** The moved array is left empty **/
+  Irreducible_lpf(Irreducible_lpf &&other);
+  Irreducible_lpf &operator=(Irreducible_lpf &&other);
+
+  /** @brief returns the value of the LPF-array at the given position
+   *
+   **/
+  UINT operator[](const UINT i) const {
+    UINT j = _rank(i + 1); // irreducible positions up to i
+    return _values[j - 1] - (i - _select(j));
+  }
+
+  /** @brief returns the length of the LPF-array
+   *
+   **/
+  UINT size() const { return _starts.size(); }
+
+  /** @brief returns the number of the irreducible positions
+   *
+   **/
+  UINT get_numberof_irreducible() const { return _values.size(); }
+
+  /** @brief returns the value at the given irreducible position (counted
+   *from 0)
+   *
+   **/
+  UINT get_irreducible_value(const UINT j) const { return _values[j]; }
+
+  /** @brief decodes the whole LPF-array into the given vector
+   *
+   **/
+  void get_lpf(std::vector<UINT> &lpf) const;
+
+  /** @brief returns the space used by the array (in bytes)
+   *
+   **/
+  uint64_t size_in_bytes() const;
+
+  /** @brief writes the array (the structures of SDSL as they are serialized)
+   *to the given stream
+   * @return number of the bytes written
+   *
+   **/
+  uint64_t serialize(std::ostream &out) const;
+
+  /** @brief reads the array written by serialize from the given memory
+   * @return execution status // SUCCESS if a valid array is read, otherwise
+   *ERR_INVALID_INPUT
+   *
+   **/
+  ReturnStatus load(const char *begin, const char *end);
+
+  /** @brief returns whether the position i (> 0) of the given LPF-array is
+   *irreducible
+   *
+   **/
+  static bool is_irreducible(const std::vector<UINT> &lpf, const UINT i) {
+    return lpf[i] + 1 != lpf[i - 1]; // LPF[i-1] - 1 is none if LPF[i-1] = 0
+  }
+
+  //////////////////////// private ////////////////////////
+private:
+  sdsl::sd_vector<> _starts;             //< irreducible positions marked
+  sdsl::sd_vector<>::rank_1_type _rank;  //< rank of the marked positions
+  sdsl::sd_vector<>::select_1_type _select; //< select of them
+  sdsl::int_vector<> _values;            //< value at each of them
+
+  /** @brief binds the rank and select structures to the positions
+   *
+   **/
+  void bind();
+};
+
+} // end namespace
+#endif
@@ -0,0 +1,163 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Lpf_file.hpp
+ * @brief Defines the formats of the output file (text and binary) and the
+ * class Lpf_reader of the binary one.
+ * Binary format (little endian; every field is aligned to 8 bytes, so that
+ * the arrays can be read in place from a mapped file):
+ * - The file starts with cLpf_file_magic (8 bytes).
+ * - A record for each sequence:
+ *   -- cLpf_record_magic (4 bytes) and the length of the name (4 bytes),
+ *   -- the name, padded with zeros to a multiple of 8 bytes,
+ *   -- n (the length of the sequence), k (the number of the degenerate
+ *   symbols), the execution time (a double) and the width of a value in bits
+ *   (ceil(log2(max LPF + 1)), at least 1), 8 bytes each,
+ *   -- the LPF-array bit-packed in 64-bit words, as the data of an
+ *   sdsl::int_vector of that width.
+ * - Or a record of an LPF-array stored by its irreducible positions (see
+ * Irreducible_lpf): cLpf_irreducible_magic, the name and the header as above
+ * (the width is that of the values), the number of the bytes of the array
+ * (8 bytes), then the array as it is serialized, padded with zeros to a
+ * multiple of 8 bytes.
+ */
+
+#ifndef LPF_FILE_HPP
+#define LPF_FILE_HPP
+
+#include <sdsl/int_vector.hpp>
+
+#include "Irreducible_lpf.hpp"
+#include "Mapped_file.hpp"
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+const char cLpf_file_magic[8] = {'D', 'E', 'G', 'L', 'P', 'F', 'B', '1'};
+const char cLpf_record_magic[4] = {'L', 'P', 'F', 'R'};
+const char cLpf_irreducible_magic[4] = {'L', 'P', 'F', 'I'};
+
+/** @brief appends the block of the given LPF-array of a sequence in the
+ *text format to the given string
+ * @param out the text of the output (the values are formatted in place)
+ * @param name name of the sequence
+ * @param exec_time execution time of the calculation (in sec)
+ * @param num_symbols number of the degenerate symbols of the sequence
+ * @param lpf the LPF-array
+ * @param num_threads number of threads formatting the values (a chunk of
+ *them each at a time)
+ *
+ **/
+void write_text_record(std::string &out, const std::string &name,
+                       const double exec_time, const UINT num_symbols,
+                       const std::vector<UINT> &lpf,
+                       const UINT num_threads = 1);
+
+/** @brief writes the record of the given LPF-array of a sequence in the
+ *binary format
+ * @param out stream of the output
+ * The other parameters are as of write_text_record.
+ *
+ **/
+void write_binary_record(std::ostream &out, const std::string &name,
+                         const double exec_time, const UINT num_symbols,
+                         const std::vector<UINT> &lpf);
+
+/** @brief writes the record of the given LPF-array of a sequence, stored by
+ *its irreducible positions, in the binary format
+ * @param out stream of the output
+ * The other parameters are as of write_text_record.
+ *
+ **/
+void write_irreducible_record(std::ostream &out, const std::string &name,
+                              const double exec_time, const UINT num_symbols,
+                              const Irreducible_lpf &lpf);
+
+/** A record of a binary LPF file, read in place **/
+struct Lpf_record {
+  std::string name;      //< name of the sequence
+  UINT size;             //< length of the sequence (of the LPF-array)
+  UINT num_symbols;      //< number of the degenerate symbols
+  double exec_time;      //< execution time of the calculation (in sec)
+  uint8_t width;         //< bits of a value
+  const uint64_t *words; //< the bit-packed LPF-array (in the mapped file)
+  bool is_irreducible;   //< the array is stored by its irreducible positions
+  Irreducible_lpf irreducible; //< the array (if so; read from the file)
+
+  /** @brief returns the value of the LPF-array at the given position
+   *
+   **/
+  UINT operator[](const UINT i) const {
+    if (is_irreducible) {
+      return irreducible[i];
+    }
+    uint64_t bit = static_cast<uint64_t>(i) * width;
+    return sdsl::bits::read_int(words + (bit >> 6), bit & 0x3f, width);
+  }
+
+  /** @brief copies the LPF-array into the given vector
+   *
+   **/
+  void get_lpf(std::vector<UINT> &lpf) const;
+};
+
+/** Class Lpf_reader
+ * Reads the records of a binary LPF file one after another, mapping the file
+ * in memory: a record refers to its array in the mapped file (valid as long
+ * as the reader).
+ */
+class Lpf_reader {
+
+public:
+  /** @brief opens the given binary LPF file
+   * @return execution status // SUCCESS if the file is opened and has the
+   *header of the format, otherwise the corresponding error code
+   *
+   **/
+  ReturnStatus open(const std::string &filename);
+
+  /** @brief reads the next record
+   * @param record reference to the record to be set up
+   * @return execution status // SUCCESS if a record is read, ERR_LIMIT_EXCEEDS
+   *at the end of the file, otherwise ERR_INVALID_INPUT (a truncated or
+   *invalid record)
+   *
+   **/
+  ReturnStatus next(Lpf_record &record);
+
+  //////////////////////// private ////////////////////////
+private:
+  Mapped_file _file;         //< the mapped file
+  const char *_next = nullptr; //< start of the next record
+};
+
+/** @brief converts the given binary LPF file into the text format
+ * @param filename name of the binary file
+ * @param out stream of the text output
+ * @return execution status // SUCCESS if all the records are converted,
+ *otherwise the corresponding error code
+ *
+ **/
+ReturnStatus convert_to_text(const std::string &filename, std::ostream &out);
+
+/** @brief converts the records left in the given (opened) reader into the
+ *text format
+ * @return execution status // as of the other convert_to_text
+ *
+ **/
+ReturnStatus convert_to_text(Lpf_reader &reader, std::ostream &out);
+
+} // end namespace
+#endif
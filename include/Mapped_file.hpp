@@ -0,0 +1,62 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Mapped_file.hpp
+ * @brief Defines the class Mapped_file.
+ * A Mapped_file is a (regular) file mapped read-only into memory, so that its
+ * records are parsed where they are, without being copied.
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+class Mapped_file {
+
+public:
+  Mapped_file() = default;
+  Mapped_file(const Mapped_file &) = delete;
+  Mapped_file &operator=(const Mapped_file &) = delete;
+  ~Mapped_file();
+
+  /** @brief maps the given file into memory
+   * @param filename name of the file
+   * @return execution status // SUCCESS if the file is mapped, otherwise
+   *ERR_FILE_OPEN (e.g. the file is a pipe and cannot be mapped)
+   *
+   **/
+  ReturnStatus open(const std::string &filename);
+
+  /** @brief returns the start of the mapped file
+   *
+   **/
+  const char *begin() const { return _data; }
+
+  /** @brief returns the end of the mapped file
+   *
+   **/
+  const char *end() const { return _data + _size; }
+
+  //////////////////////// private ////////////////////////
+private:
+  const char *_data = nullptr; //< start of the mapping
+  size_t _size = 0;            //< size of the file
+};
+
+} // end namespace
+#endif
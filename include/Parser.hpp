@@ -21,19 +21,23 @@
 #ifndef PARSER_HPP
 #define PARSER_HPP
 
+#include <array>
+
 #include "Degenerate_string.hpp"
 #include "globalDefs.hpp"
 
 namespace deglpf {
 /** Class Parser
  * A Parser contains the method for parsing a sequence into the encoded sequence of integers.
+ * The code of every character (0 if it is not valid in the alphabet) is
+ * looked up in a table of 256 entries, filled once by the constructor.
+ * The letters of a seed are decoded in runs (found 16 bytes at a time, up to
+ * the next whitespace or brace) straight into the degenerate string.
+ * An ambiguity code (IUPAC) of the DNA or Protein alphabet is a degenerate
+ * symbol of its letters; its mask is looked up in a second table.
  *
  */
 class Parser {
-  // Type of function for checking validity of a character
-  using FCheckValidity = bool (Parser::*)(const char) const;
-  // Type of function for mapping a valid character to encoded character
-  using FMapChar = ENCODED_CHAR (Parser::*)(const char) const;
 
 public:
   /** @brief Constructor for Class Parser
@@ -46,7 +50,7 @@ public:
   Parser(const AlphabetType alphabetType, const std::string &alphabet);
 
   /** @brief parses sequence into encoded sequence of integers.
- * Length of one integer defined by ENCODED_CHAR: Currently 1 byte long
+ * Length of one integer defined by ENCODED_CHAR: Currently 4 bytes long
  * Input sequence should be in Fasta format: It returns only one sequence
  * Ignores spaces between charcters.
  * Degenerate symbol:
@@ -56,21 +60,74 @@ public:
  at all.
  *  - Letters may be repeated but counted as one.
  *  - At least two letters should be present.
+ *  - An ambiguity code (e.g. N or R for DNA) stands for its letters.
+ * An ambiguity code in a seed is a degenerate symbol on its own.
  * Returns on encountering an invalid character or if a symbol did not close or
  did not have at least two letters.
- * @param infile handle of the file (currently pointing at the beginning of the
- sequence)
+ * @param infile handle of the file or stream (currently pointing at the
+ beginning of the sequence)
  * @param dgs reference to the degenerate string to be set up from the read
  sequence
  * @return execution status // SUCCESS if input is valid, otherwise
  corresponding error code after logging the error
  **/
-  ReturnStatus parse_sequence(std::ifstream &infile,
+  ReturnStatus parse_sequence(std::istream &infile,
                               Degenerate_string &dgs) const;
 
+  /** @brief parses the sequence in the given range of memory (e.g. of a
+ mapped file) into encoded sequence of integers
+ * The range holds the lines of one sequence (without its header); newlines
+ are ignored as the other spaces. Otherwise as parse_sequence(infile, dgs).
+ * @param begin start of the sequence
+ * @param end end of the sequence
+ * @param dgs reference to the degenerate string to be set up from the
+ sequence
+ * @param sites variants of the sequence (if any), in the order of their
+ positions: the symbol at the position of a variant becomes a degenerate
+ symbol of its letters and those of the variant
+ * @see Variant_sites
+ * @return execution status // SUCCESS if input is valid, otherwise
+ corresponding error code after logging the error
+ **/
+  ReturnStatus parse_sequence(const char *begin, const char *end,
+                              Degenerate_string &dgs,
+                              const std::vector<Variant_site> *sites =
+                                  nullptr) const;
+
+  /** @brief returns the mask of the letters the given character stands for:
+   *the letter itself or the letters of an ambiguity code (0 if it is not
+   *valid)
+   * Assumes the codes of the letters to be below cMask_bits.
+   *
+   **/
+  SYMBOL_MASK letter_mask(const char c) const {
+    return (code_of(c) != 0) ? (SYMBOL_MASK(1) << code_of(c))
+                             : (ambiguity_mask_of(c));
+  }
+
 private:
   const AlphabetType _cAlphabetType; ///< Type of alphabet: DNA, PROT or GEN
   const std::string _cAlphabet;      ///< Original alphabet
+  std::array<uint8_t, 256> _codes;   ///< code of each character (0: invalid)
+  /** mask of the letters of each character that is an ambiguity code (0 for
+   * the others) */
+  std::array<SYMBOL_MASK, 256> _ambiguity_masks;
+
+  /** @brief returns the code of the given character (0 if it is not valid in
+   *the alphabet)
+   *
+   **/
+  uint8_t code_of(const char c) const {
+    return _codes[static_cast<unsigned char>(c)];
+  }
+
+  /** @brief returns the mask of the letters of the given ambiguity code (0
+   *if it is not one)
+   *
+   **/
+  SYMBOL_MASK ambiguity_mask_of(const char c) const {
+    return _ambiguity_masks[static_cast<unsigned char>(c)];
+  }
 
   /** @brief checks whether the given character is valid in the alphabet for
   which the parser is set
@@ -0,0 +1,190 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Pipeline.hpp
+ * @brief Defines the class Pipeline.
+ * A Pipeline calculates the LPF-arrays of all the records (sequences) of a
+ * FASTA file:
+ * - A reader splits the input into records. The records of a file mapped in
+ * memory are not copied; the workers parse them where they are.
+ * - Workers parse the records and calculate their LPF-arrays, a few records
+ * at a time. Consecutive records may be taken in groups sharing one index
+ * (see Shared_index); this suits many short records.
+ * - A writer writes the results in the order of the records in the input.
+ * The records read but not yet written are bounded; so is the memory in use.
+ */
+
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Parser.hpp"
+#include "Shared_index.hpp"
+#include "Variant_sites.hpp"
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+class Pipeline {
+  /** A Record is a sequence of the input on its way through the pipeline
+   * **/
+  struct Record {
+    std::string name;   //< name of the sequence (its header without '>')
+    std::string body;   //< lines of the sequence (if read from a stream)
+    const char *begin = nullptr; //< start of the lines (in body or mapped)
+    const char *end = nullptr;   //< end of the lines
+    std::string result; //< block of the output file for this sequence
+    std::string stats;  //< statistics of the calculation (if asked)
+    ReturnStatus status = ReturnStatus::SUCCESS; //< status of the record
+    bool done = false; //< whether the result is ready to be written
+  };
+
+public:
+  /** @brief Constructor for Class Pipeline
+   * @param parser parser of the sequences
+   * @param alphabet_size size of the alphabet of the sequences
+   * @param search_options options for calculating each LPF-array
+   * @param options options of the pipeline
+   * @param variant_sites sites of variants applied to the sequences while
+   *they are parsed (if any)
+   * @see SearchOptions
+   * @see PipelineOptions
+   * @see Variant_sites
+   *
+   **/
+  Pipeline(const Parser &parser, const UINT alphabet_size,
+           const SearchOptions &search_options,
+           const PipelineOptions &options = PipelineOptions(),
+           const Variant_sites *variant_sites = nullptr);
+
+  /** @brief calculates the LPF-array of each record of the input and writes
+   *them (in the order of the records) to the output
+   * Stops at the first invalid record; the records before it are written.
+   * @param infile stream of the input (FASTA format)
+   * @param outfile stream of the output
+   * @return execution status // SUCCESS if all the records are valid,
+   *otherwise the error of the first invalid one
+   *
+   **/
+  ReturnStatus run(std::istream &infile, std::ostream &outfile);
+
+  /** @brief calculates the LPF-array of each record of the input in the
+   *given range of memory (e.g. a mapped file) and writes them (in the order
+   *of the records) to the output
+   * The records are parsed in place; the range must outlive the call.
+   * @param begin start of the input (FASTA format)
+   * @param end end of the input
+   * @param outfile stream of the output
+   * @return execution status // as run(infile, outfile)
+   *
+   **/
+  ReturnStatus run(const char *begin, const char *end, std::ostream &outfile);
+
+  //////////////////////// private ////////////////////////
+private:
+  const Parser &_parser;                //< parser of the sequences
+  const UINT _alphabet_size;            //< size of the alphabet
+  const SearchOptions _search_options;  //< options of each calculation
+  const UINT _num_workers;              //< groups processed concurrently
+  const UINT _group_size;               //< records sharing one index
+  const UINT _max_in_flight;            //< records read but not yet written
+  const bool _print_stats;              //< print statistics of each record
+  const OutputFormat _output_format;    //< format of the output
+  const Variant_sites *_variant_sites;  //< variants of the sequences
+
+  std::mutex _mutex;                    //< guards the state below
+  std::condition_variable _read_cv;     //< a record may be read
+  std::condition_variable _work_cv;     //< a record may be processed
+  std::condition_variable _write_cv;    //< a record may be written
+  std::deque<std::shared_ptr<Record>> _in_flight; //< in the order of input
+  /** groups of records not yet processed */
+  std::deque<std::vector<std::shared_ptr<Record>>> _pending;
+  bool _reading_done = false;           //< no more records will be read
+  bool _stop = false;                   //< stop (an invalid record is found)
+
+  /** @brief reads the records and hands them over to the workers
+   * Waits while the number of records in flight is at its bound.
+   * @param infile stream of the input
+   * @param header first line of the first record
+   *
+   **/
+  void read_records(std::istream &infile, std::string header);
+
+  /** @brief reads the records in the given range of memory (without copying
+   *them) and hands them over to the workers
+   * As read_records; the first line is in the range.
+   *
+   **/
+  void read_mapped_records(const char *begin, const char *end);
+
+  /** @brief starts the workers and writes the results of the records (in
+   *their order) until the given reader and the workers are done
+   * @return execution status // as run(infile, outfile)
+   *
+   **/
+  ReturnStatus write_records(std::thread &reader, std::ostream &outfile);
+
+  /** @brief waits for a record to be written if the number of records in
+   *flight is at its bound
+   * @return false if the pipeline stops (no more records are to be read)
+   *
+   **/
+  bool wait_to_read();
+
+  /** @brief adds a record (in flight, invalid) for a header line which
+   *does not start with '>'
+   *
+   **/
+  void add_invalid_header();
+
+  /** @brief processes the groups of records handed over by the reader until
+   *there are no more
+   *
+   **/
+  void process_records();
+
+  /** @brief parses the records of the given group and calculates their
+   *LPF-arrays (with one index for all of them, unless the groups are of one
+   *record); the result of a record is its block of the output file
+   *
+   **/
+  void process_group(const std::vector<std::shared_ptr<Record>> &group) const;
+
+  /** @brief calculates the LPF-array of the given (parsed) record; the index
+   *is its own unless a shared one is given
+   *
+   **/
+  void calculate_record(Record &record, const Degenerate_string &dgs,
+                        const Shared_index *shared_index,
+                        const UINT str) const;
+
+  /** @brief adds the given record to those in flight (in the order of input)
+   *
+   **/
+  void add_in_flight(const std::shared_ptr<Record> &record);
+
+  /** @brief hands the given group of records over to the workers
+   *
+   **/
+  void hand_over(std::vector<std::shared_ptr<Record>> &group);
+};
+
+} // end namespace
+#endif
@@ -0,0 +1,102 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+    Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Prefix_table.hpp
+ * @brief Defines the class Prefix_table.
+ * It stores the table of the longest degenerate prefixes (k-lcp) compactly:
+ * all the cells are bit-packed in a single (contiguous) array of words.
+ * - The width of a cell is the smallest of 8, 16, 32 and 64 bits that can
+ * hold the largest possible value; so a cell never spans two machine words.
+ * - A cell stores its value + 1; 0 marks an unfilled cell (read as -1).
+ * - The words are anonymous pages of memory, zero until written: a page is
+ * backed by memory only once a cell of it is written (so a table filled
+ * lazily takes only the pages of the cells filled).
+ * - Cells are laid out symbol-major (row by row) or position-major (column by
+ * column).
+ * - Cells are read and written atomically; a cell is written once (or again
+ * with the same value), which allows the table to be filled concurrently.
+ *
+ * Provides methods for the following:
+ * - Reading a cell.
+ * - Writing a cell.
+ * - Prefetching a cell.
+ */
+
+#ifndef PREFIX_TABLE_HPP
+#define PREFIX_TABLE_HPP
+
+#include <sdsl/int_vector.hpp>
+
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+class Prefix_table {
+
+public:
+  /** @brief Constructor for Class Prefix_table
+   * All the cells are unfilled.
+   * @param num_rows number of the rows (degenerate symbols)
+   * @param num_cols number of the columns (positions)
+   * @param max_value largest value that can be stored in a cell
+   * @param layout order in which the cells are laid out
+   * @see TableLayout
+   *
+   */
+  Prefix_table(const UINT num_rows, const UINT num_cols, const UINT max_value,
+               const TableLayout layout = TableLayout::SYMBOL_MAJOR);
+  ~Prefix_table();
+
+  Prefix_table(const Prefix_table &) = delete;
+  Prefix_table &operator=(const Prefix_table &) = delete;
+
+  /** @brief returns the value of the given cell; -1 if it is unfilled
+   *
+   **/
+  INT get(const UINT row, const UINT col) const;
+
+  /** @brief writes the given value in the given cell
+   * Assumes the cell to be unfilled or to hold the same value already
+   *
+   **/
+  void set(const UINT row, const UINT col, const INT value);
+
+  /** @brief prefetches the given cell into the cache
+   *
+   **/
+  void prefetch(const UINT row, const UINT col) const;
+
+  /** @brief returns the width (in bits) of a cell
+   *
+   **/
+  UINT get_width() const;
+
+  //////////////////////// private ////////////////////////
+private:
+  const UINT _num_rows;       //< number of the rows
+  const UINT _num_cols;       //< number of the columns
+  const TableLayout _layout;  //< order of the cells
+  uint8_t _width;             //< bits of a cell
+  uint64_t _num_bytes = 0;    //< size of the cells (whole words)
+  uint64_t *_words = nullptr; //< cells (value + 1), mapped anonymously
+
+  /** @brief returns the position of the given cell in the vector
+   *
+   **/
+  uint64_t cell_index(const UINT row, const UINT col) const;
+};
+
+} // end namespace
+#endif
@@ -19,19 +19,19 @@
  * calculate LPF-array using our algorithm and using the naive method as well.
  * Note that here, a solid sequence means the degnerate string where the
  * degenerate symbols have been replaced by unique letters.
- * ASSUMPTION: TOTAL NUMBER OF DEGENERATE SYMBOLS ARE SMALLER THAN 255 - ALPHABET SIZE
  */
 
 #ifndef SEARCH_HPP
 #define SEARCH_HPP
 
-#include <list>
 #include <algorithm>
-#include <sdsl/lcp.hpp>
-#include <sdsl/rmq_support.hpp>
-#include <sdsl/suffix_arrays.hpp>
+#include <sdsl/int_vector.hpp>
 
 #include "Degenerate_string.hpp"
+#include "Irreducible_lpf.hpp"
+#include "Prefix_table.hpp"
+#include "Search_index.hpp"
+#include "Shared_index.hpp"
 #include "globalDefs.hpp"
 
 namespace deglpf {
@@ -39,20 +39,95 @@ namespace deglpf {
 class Search {
   /** A SearchDS structure provides the data-structures to make the LCP queries
    * in constant time
+   * The sequence itself is the flat sequence of the degenerate string; a query
+   * first compares a few symbols of it directly.
+   * The index is either built for this sequence alone or shared with other
+   * sequences (see Shared_index); then the sequence is at the given offset in
+   * the indexed one.
   * **/
   struct SearchDS {
-    sdsl::csa_bitcompressed<> csa; //<Compreseed suffix array and its inverse
-    sdsl::lcp_bitcompressed<> lcp; // < lcp array
-    sdsl::rmq_succinct_sct<>
-        rmq; // data-structure to answer rmq in constant time
+    std::unique_ptr<Search_index> own_index; //< index of this sequence alone
+    const Search_index *index = nullptr; //< index queried (own or shared)
+    UINT offset = 0; //< position of the solid sequence in the indexed one
+    bool is_reverse; //< whether the index is of the reverse solid sequence
+  };
+
+  /** An LCP_batch structure collects the LCP queries to be answered together
+   * (see getLCPs); each query carries a tag for the use of the caller
+  * **/
+  struct LCP_batch {
+    std::vector<UINT> suff1;   //< first suffix of each query
+    std::vector<UINT> suff2;   //< second suffix of each query
+    std::vector<UINT> tag;     //< tag of each query
+    std::vector<UINT> lcp;     //< answer of each query
+    std::vector<UINT> pending; //< queries left for the index
+    std::vector<UINT> rank1;   //< rank of the first suffix of pending queries
+    std::vector<UINT> rank2;   //< rank of the second suffix of pending queries
+
+    void add(const UINT s1, const UINT s2, const UINT t) {
+      suff1.push_back(s1);
+      suff2.push_back(s2);
+      tag.push_back(t);
+    }
+    void clear() {
+      suff1.clear();
+      suff2.clear();
+      tag.clear();
+    }
+    UINT size() const { return suff1.size(); }
+  };
+
+  /** A Chain_link is a cell of the table in a chain of degenerate matches
+   * (see fill_longest_degenerate_match) with the length of its own match
+   * (up to the following cell of the chain)
+  * **/
+  struct Chain_link {
+    UINT symb; //< index of the degenerate symbol of the cell
+    UINT pos;  //< position of the cell
+    INT match; //< length of the match before the following cell
   };
 
 public:
+  /** Chain_stats gives the lengths of the chains of degenerate matches
+   * resolved to fill the table (a chain is a cell followed by the unfilled
+   * cells its match runs into)
+   * Long chains point out runs of compatible degenerate symbols.
+  * **/
+  struct Chain_stats {
+    uint64_t num_chains = 0; //< number of chains resolved
+    uint64_t num_cells = 0;  //< number of cells filled by the chains
+    UINT longest = 0;        //< length of the longest chain
+
+    void add(const Chain_stats &other) {
+      num_chains += other.num_chains;
+      num_cells += other.num_cells;
+      longest = std::max(longest, other.longest);
+    }
+  };
+
   /** @brief Constructor for Class Search
      * @param dgs reference to the degenerate string for which it will be set
+     * @param options options for calculating the LPF-array
+     * @see SearchOptions
+     *
+     */
+  Search(const Degenerate_string &dgs,
+         const SearchOptions &options = SearchOptions());
+
+  /** @brief Constructor for Class Search using an index shared with other
+   *strings
+   * The index is not built again; the LPF-array is still that of the given
+   *string alone.
+     * @param dgs reference to the degenerate string for which it will be set
+     * @param shared_index index of several strings (including this one)
+     * @param str index of this string among the strings of the shared index
+     * @param options options for calculating the LPF-array (the shared index
+     *must have been built with the same options)
+     * @see Shared_index
      *
      */
-  Search(const Degenerate_string &dgs);
+  Search(const Degenerate_string &dgs, const Shared_index &shared_index,
+         const UINT str, const SearchOptions &options = SearchOptions());
 
   /** @brief calculates the LPF-array using our algorithm
    * @param lpf reference to the vector in which result will be stored
@@ -60,19 +135,54 @@ public:
    **/
   ReturnStatus calculate_lpf(std::vector<UINT> &lpf);
 
+  /** @brief calculates the LPF-array using our algorithm and stores it by its
+   *irreducible positions (found by the last pass over the positions)
+   * @param lpf reference to the array in which result will be stored
+   * @see Irreducible_lpf
+   *
+   **/
+  ReturnStatus calculate_lpf(Irreducible_lpf &lpf);
+
   /** @brief checks whether the given LPF-array is same as would be calculated
    *using the naive approach
    * @param lpf reference to the LPF-array which is to be tested
    *
    **/
   bool naive_test(std::vector<UINT> &lpf) const;
+
+  /** @brief returns the statistics of the chains of degenerate matches
+   *resolved so far (by all the threads)
+   * @see Chain_stats
+   *
+   **/
+  Chain_stats get_chain_stats() const;
   //////////////////////// private ////////////////////////
 private:
+  /** @brief Constructor for Class Search with its own index (if the shared
+   *index is nullptr) or the shared one
+   *
+   */
+  Search(const Degenerate_string &dgs, const Shared_index *shared_index,
+         const UINT str, const SearchOptions &options);
+
+  /** @brief calculates the LPF-array in the given vector; if irreducible is
+   *not nullptr, the irreducible positions are added to it (in order)
+   *
+   **/
+  ReturnStatus calculate(std::vector<UINT> &lpf,
+                         std::vector<UINT> *irreducible);
+
   const Degenerate_string &_dgs; //< reference to the degenerate string
   const std::vector<UINT> &_degenerate_indices; //< reference to the positions
                                                 // of the degenerate symbols
+  const std::vector<UINT> &_seed_offsets; //< reference to the starting
+                                          // positions of the seeds
+  const std::vector<ENCODED_CHAR> &_symbols; //< reference to the sequence
   const UINT _seq_size;                         // size of the string
   const UINT _k; //< number of the degenerate symbols
+  const SearchOptions _options; //< options of the search
+  const Shared_index *_shared_index; //< index shared with other strings
+  const UINT _shared_str; //< index of this string in the shared index
 
   Search::SearchDS
       _fwd_search_ds; //< Search Data-structures for the forward LCP queries
@@ -80,8 +190,10 @@ private:
       _rev_search_ds; //< Search Data-structures for the reverse LCP queries
   /** For each letter of the alphabet, maintain the list of the indices of its
    * occurrence in the reverse sequence. Sorted in descending order wrt
-   * reverse..*/
-  std::vector<std::list<UINT>> _letter_ind_in_rev;
+   * reverse; those of letter c are at [_letter_offsets[c],
+   * _letter_offsets[c + 1]) (all the lists are stored in one vector) */
+  std::vector<UINT> _letter_ind_in_rev;
+  std::vector<UINT> _letter_offsets; //< start of the occurrences of a letter
   /** vector of lpf in the solid sequence (obtained after substituting
    * degenerate symbol with unique letters) */
   std::vector<UINT> _solid_lpf;
@@ -91,9 +203,19 @@ private:
    * Number of rows = k; Number of columns = n
    * _longest_degenerate_prefix[i][j] = l => k-lcp of ith deg-symbol and jth
    * position (in solid-sequence) is l
-   * The table is initialised to -1 in each cell
+   * The table is initialised to -1 (unfilled) in each cell; its cells are
+   * bit-packed in a single vector
+   * @see Prefix_table
+   * In lazy mode, only the cells that are read (and those they depend on) are
+   * ever filled
    */
-  std::vector<std::vector<INT>> _longest_degenerate_prefix;
+  Prefix_table _longest_degenerate_prefix;
+
+  /** Chain of the cells being filled and the statistics of the chains, for
+   * each thread; the chain is reused by each fill (see
+   * fill_longest_degenerate_match) */
+  std::vector<std::vector<Chain_link>> _chains;
+  std::vector<Chain_stats> _chain_stats;
 
   /** @brief does the preprocessing:
    *  - Computes the data-structures to answer lcp queries (in constant time) in
@@ -106,23 +228,144 @@ private:
    **/
   ReturnStatus preprocess(std::vector<UINT> &lpf);
 
-  /** @brief Fills the longest degenerate match between given indices in the
-   *table
-   * - Recursively fills all the cells of the table which are made use of to
-   *answer this query
+  /** @brief Checks the candidates of the given position in the L-regions
+   *whose LCP queries are in the given batch; the batch is emptied
+   * - A query (pos, i) tagged j checks the position pos of the jth seed
+   * @param i the position whose lpf is being calculated
+   * @return the longest of the matches found
+   *
+   **/
+  UINT check_l_regions(const UINT i, Search::LCP_batch &batch);
+
+  /** @brief Checks the candidates of the L-region of the given block (seed)
+   *at all the following positions (LRegionSearch::BORDERS)
+   * - A KMP pass of the reversed seed over the reversed sequence; at a
+   *position, the matched prefix and its borders are exactly the suffixes of
+   *the seed that are prefixes of the suffix at the position
+   * - The lpf at a position is updated atomically (blocks are processed
+   *concurrently)
+   * @param j index of the block (seed)
+   * @param lpf reference to the LPF-array being calculated
+   *
+   **/
+  void find_l_region_candidates(const UINT j, std::vector<UINT> &lpf);
+
+  /** @brief Fills the table of longest degenerate match one symbol (row) at
+   *a time (one position at a time in the position-major layout)
+   * - The LCP queries of the matching cells are answered in batches
+   * @see fill_longest_degenerate_match
+   * @see _longest_degenerate_prefix
+   *
+   **/
+  void fill_table_by_rows();
+
+  /** @brief Fills the cell of the given symbol and position, if unfilled
+   * - A matching cell needs an LCP query; it is added to the given batch
+   *(filled when the batch is full) instead
+   * @see fill_longest_degenerate_match
+   * @see fill_batched_cells
+   *
+   **/
+  void fill_cell(const UINT symb, const UINT pos, Search::LCP_batch &batch);
+
+  /** @brief Answers the LCP queries of the cells in the given batch and fills
+   *those cells (if still unfilled); the batch is emptied
+   * @see fill_cell
+   *
+   **/
+  void fill_batched_cells(Search::LCP_batch &batch);
+
+  /** @brief Fills the table of longest degenerate match one diagonal at a time
+   * - A diagonal d consists of the pairs of positions (p, p+d) of which at
+   *least one is a degenerate symbol
+   * - The cell of a pair depends (at most) on the cell of a pair further along
+   *the same diagonal; so a diagonal is filled from its end, and the diagonals
+   *are filled concurrently
+   * - The result is identical to that of filling by rows
+   * @see _longest_degenerate_prefix
+   *
+   **/
+  void fill_table_by_diagonals();
+
+  /** @brief Fills the cells of the given diagonal
+   * @param diag difference between the positions of the pairs of the diagonal
+   * @see fill_table_by_diagonals
+   *
+   **/
+  void fill_diagonal(const UINT diag);
+
+  /** @brief returns the cell of the table for the given pair of positions
+   * Assumes at least one of the positions is a degenerate symbol
+   * @see _longest_degenerate_prefix
+   *
+   **/
+  INT get_degenerate_prefix(const UINT pos1, const UINT pos2) const;
+
+  /** @brief returns the cell of the table for the given symbol and position
+   * - In lazy mode, the cell is filled if it is read for the first time; a
+   *mismatch (0) is returned without being remembered
+   * - Safe to be called concurrently
+   * @param symb index of the degenerate symbol
+   * @param pos position in the sequence
+   * @see FillType
+   * @see _longest_degenerate_prefix
+   *
+   **/
+  INT get_longest_degenerate_prefix(const UINT symb, const UINT pos);
+
+  /** @brief Fills the table of TYPE 2 Search for the given block
+   * - The table gives, for each length l of the solid suffix of the seed, the
+   *longest match that ends in this seed by l letters and continues into the
+   *following degenerate symbol
+   * - Left empty if no position in the block needs TYPE 2 Search
+   * - Only reads the shared tables (or fills their cells lazily); hence blocks
+   *can be filled concurrently
+   * @param block index of the seed (block)
+   * @param type2_result reference to the vector in which table will be stored
+   *
+   **/
+  void fill_type2_table(const UINT block, std::vector<UINT> &type2_result);
+
+  /** @brief Finds the candidates of TYPE 2 Search of the given block by
+   *scanning the occurrences of the last letter of its seed
+   * - Used without the reverse index; the backward extensions are read from
+   *the Z-array of the reversed seed against the reversed sequence
+   * @param block index of the seed (block)
+   * @param type2_local the table of the block (indexed by the reverse lcp)
+   *
+   **/
+  void find_type2_candidates_by_z_array(const UINT block,
+                                        std::vector<UINT> &type2_local);
+
+  /** @brief Updates the table of TYPE 2 Search of the given block with the
+   *match that ends by the given reverse lcp at the occurrence p (in reverse)
+   *and continues into the following degenerate symbol
+   *
+   **/
+  void add_type2_candidate(const UINT block, const UINT p, const UINT rev_lcp,
+                           std::vector<UINT> &type2_local);
+
+  /** @brief Fills the longest degenerate match between given symbol and
+   *position in the table
+   * - Fills all the cells of the table which are made use of to answer this
+   *query: the match runs into the cell of the following degenerate symbol,
+   *whose match may run into another one, and so on. This chain is followed
+   *(without recursion) up to a filled cell or a mismatch, and then resolved
+   *backwards in the chain buffer of the calling thread
    * - Note that a cell is filled using a single LCP call and making use of
    *results of other cells of the table
    * - Note that call to this function is made only when the cell was set to -1
-   * - Assumes the first index to be that of some degenerate symbol
-   * @param index_dg reference to the index of some degenerate symbol
-   * @param index2 reference to the index of some position (may be a symbol or a
-   *solid position in some seed)
+   * @param symb_ind index of some degenerate symbol
+   * @param pos2 some position (may be a symbol or a solid position in some
+   *seed)
+   * @param known_lcp lcp of the positions following the given ones, if it is
+   *already known (-1 otherwise)
    *
    * @see _longest_degenerate_prefix
    *
    **/
-  void fill_longest_degenerate_match(const INDEX &index_dg,
-                                     const INDEX &index2);
+  void fill_longest_degenerate_match(const UINT symb_ind, const UINT pos2,
+                                     const INT known_lcp = -1);
 
   /** @brief Compute the data-structures to answer lcp queries (in constant
    *time) in forward as well as reverse of the solid sequence
@@ -143,49 +386,73 @@ private:
 Previous Factor" by
 Maxime Crochemore, Lucian Ilie, Costas Iliopoulos, Marcin Kubica, Wojciech
 Rytter, Tomasz Waleń)
+   * With a shared index, it runs over the ranks of this sequence only (the
+   *lcp of consecutive ones is a query of the index).
    * @see _solid_lpf
    *
    **/
   ReturnStatus find_solid_lpf();
 
-  /** @brief Helper to compute the data-structures to answer lcp queries (in
+  /** @brief Helper to set up the data-structures to answer lcp queries (in
    *constant
-   *time) in given sequence
-   * Uses SDSL library
-   * @param seq reference to the sequence for the data-structures are to be
-   *computed
+   *time) with an index of their own (to be built)
+   * The profile of the index is taken from the options
    * @param searchds reference to the structure where result will be stored
    * @see _fwd_search_ds
    * @see _rev_search_ds
    * @see SearchDS
+   * @see IndexProfile
    *
    **/
-  void ds_helper(const std::string &seq, Search::SearchDS &searchds);
+  void ds_helper(Search::SearchDS &searchds);
 
   /** @brief Answers the k-lcp (longest degenerate match) queries at the given
-   *indices in the forward solid sequence
-   * @param index1 reference to the first index
-   * @param index2 reference to the second index
+   *positions in the forward solid sequence
+   * @param pos1 the first position
+   * @param pos2 the second position
    * @return the k-lcp value;
-   * @see _INDEX
    *
    **/
-  UINT find_longest_degenerate_match(const INDEX &index1,
-                                     const INDEX &index2) const;
+  UINT find_longest_degenerate_match(UINT pos1, UINT pos2) const;
 
   /** @brief Answers the lcp (exact) queries (in constant
    * time) at the given positions using the given data-structures
-   * - Assumption: csa, lcp, rmq are valid (only size is being checked)
+   * - The first cDirect_lce_window symbols are compared directly (with SIMD);
+   *the index is consulted only if they all match
+   * - Assumption: the index has been built
    * @param suff the first position
    * @param suff the second position
    * @param searchds reference to the structure containing all the required data
    *structures to be used for answering the queries
    * @return the lcp value; If any index > length of the sequence, returns 0
-   * @see _INDEX
    *
    **/
   INT getLCP(const INT suff1, const INT suff2,
              const Search::SearchDS &searchds) const;
+
+  /** @brief Answers all the lcp (exact) queries of the given batch
+   * - Queries are first tried directly (see getLCP); the remaining ones are
+   *answered by the index while the reads of the next cPrefetch_distance
+   *queries (ranks, and then what their range minimum query reads) are
+   *prefetched
+   * @param batch reference to the queries; answers are stored in it
+   * @param searchds reference to the structure containing all the required data
+   *structures to be used for answering the queries
+   * @see LCP_batch
+   *
+   **/
+  void getLCPs(Search::LCP_batch &batch,
+               const Search::SearchDS &searchds) const;
+
+  /** @brief Answers the lcp (exact) query at the given positions without the
+   *index, if possible
+   * - Compares the first cDirect_lce_window symbols directly (with SIMD)
+   * @param lcp reference to the answer (if answered)
+   * @return whether the query has been answered
+   *
+   **/
+  bool get_direct_LCP(const UINT suff1, const UINT suff2,
+                      const Search::SearchDS &searchds, UINT &lcp) const;
 };
 
 } // end namespace
@@ -0,0 +1,271 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Search_index.hpp
+ * @brief Defines the data-structures answering the LCP queries on a solid
+ * sequence (the index of the sequence).
+ * An index consists of the inverse suffix array, the LCP array and a range
+ * minimum query over the LCP array. It is available in the following profiles
+ * (see IndexProfile):
+ * - SUCCINCT: bit-compressed suffix and LCP arrays with a succinct RMQ.
+ * - FAST: plain 32-bit (inverse) suffix and LCP arrays with a sparse table of
+ * the range minima (O(n log n) words); a query reads four words.
+ * - COMPACT: wavelet-tree based (sampled) suffix array with a DAC-encoded LCP
+ * array and a succinct RMQ.
+ *
+ * Provides methods for the following:
+ * - Building the index of a sequence (over an integer alphabet).
+ * - Getting the rank of a suffix, the suffix at a rank and the LCP value at a
+ * rank.
+ * - Answering the LCP query of two suffixes (or of two ranks).
+ * - Prefetching what a query reads; a batch of queries resolves one query
+ * while the reads of the next few are in flight.
+ */
+
+#ifndef SEARCH_INDEX_HPP
+#define SEARCH_INDEX_HPP
+
+#include <memory>
+#include <sdsl/lcp.hpp>
+#include <sdsl/rmq_support.hpp>
+#include <sdsl/suffix_arrays.hpp>
+
+#include "Suffix_array.hpp"
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+/** @brief returns a name for the temporary (in-memory) files of a
+ *construction that no other construction uses, even concurrently
+ *
+ **/
+std::string unique_construction_id();
+
+/** @brief constructs the given SDSL suffix array and LCP array of the given
+ *sequence in memory (as sdsl::construct_im does for each)
+ * - The temporary files are named by unique_construction_id(); the names
+ *given by SDSL come from a counter that is not thread-safe. Hence the indexes
+ *of several sequences can be constructed concurrently.
+ * - Both are constructed from one cache; so the suffix array is sorted once.
+ * - With one thread, SDSL sorts the suffixes and computes the LCP array;
+ *otherwise they are computed in parallel (see Suffix_array.hpp) and SDSL
+ *builds its data-structures from them.
+ *
+ **/
+template <class t_csa, class t_lcp>
+void construct_in_memory(t_csa &csa, t_lcp &lcp, const sdsl::int_vector<> &seq,
+                         const UINT num_threads) {
+  std::string id = unique_construction_id();
+  std::string tmp_file = sdsl::ram_file_name(id);
+  sdsl::store_to_file(seq, tmp_file);
+  sdsl::cache_config config(false, "@", id); // files are removed at the end
+  if (num_threads > 1) {
+    cache_suffix_arrays(seq, num_threads, config);
+  }
+  sdsl::construct(csa, tmp_file, config, 0); // 0 for integer alphabet type
+  sdsl::construct(lcp, tmp_file, config, 0); // 0 for integer alphabet type
+  sdsl::util::delete_all_files(config.file_map);
+  sdsl::ram_fs::remove(tmp_file);
+}
+
+class Search_index {
+
+public:
+  virtual ~Search_index() {}
+
+  /** @brief builds the index of the given sequence with the given number of
+   *threads
+   * The sequence must not contain 0.
+   *
+   **/
+  virtual void build(const sdsl::int_vector<> &seq, const UINT num_threads) = 0;
+
+  /** @brief returns the number of ranks (the length of the sequence and one
+   *for the sentinel appended by SDSL)
+   *
+   **/
+  virtual UINT size() const = 0;
+
+  /** @brief returns the rank of the given suffix (inverse suffix array)
+   *
+   **/
+  virtual UINT isa(const UINT suff) const = 0;
+
+  /** @brief returns the suffix at the given rank (suffix array)
+   *
+   **/
+  virtual UINT sa(const UINT rank) const = 0;
+
+  /** @brief returns the LCP value at the given rank (LCP array)
+   *
+   **/
+  virtual UINT lcp(const UINT rank) const = 0;
+
+  /** @brief returns the length of the longest common prefix of the given
+   *suffixes
+   * Assumes the suffixes to be distinct and smaller than the length of the
+   *sequence.
+   *
+   **/
+  UINT lce(const UINT suff1, const UINT suff2) const {
+    return lce_of_ranks(isa(suff1), isa(suff2));
+  }
+
+  /** @brief returns the length of the longest common prefix of the suffixes
+   *at the given ranks
+   * Assumes the ranks to be distinct.
+   *
+   **/
+  virtual UINT lce_of_ranks(const UINT rank1, const UINT rank2) const = 0;
+
+  /** @brief prefetches the rank of the given suffix (if it is stored)
+   *
+   **/
+  virtual void prefetch_isa(const UINT /*suff*/) const {}
+
+  /** @brief prefetches what the query of the given ranks reads
+   *
+   **/
+  virtual void prefetch_ranks(const UINT /*rank1*/,
+                              const UINT /*rank2*/) const {}
+};
+
+/** @brief prefetches the (stored) rank of the given suffix
+ *
+ **/
+template <class t_alphabet>
+void prefetch_isa_of(const sdsl::csa_bitcompressed<t_alphabet> &csa,
+                     const UINT suff) {
+  __builtin_prefetch(csa.isa.data() +
+                     ((static_cast<uint64_t>(suff) * csa.isa.width()) >> 6));
+}
+
+/** @brief nothing is prefetched for a sampled inverse suffix array
+ *
+ **/
+template <class t_csa> void prefetch_isa_of(const t_csa &, const UINT) {}
+
+/** Index made of SDSL data-structures; an RMQ over the LCP array gives the
+ * lcp of two suffixes from their ranks
+ * **/
+template <class t_csa, class t_lcp, class t_rmq>
+class Sdsl_search_index : public Search_index {
+
+public:
+  void build(const sdsl::int_vector<> &seq, const UINT num_threads) {
+    construct_in_memory(_csa, _lcp, seq, num_threads);
+    _rmq = t_rmq(&_lcp);
+    // rmq does not need its arg to answer the queries
+  }
+
+  UINT size() const { return _csa.size(); }
+
+  UINT isa(const UINT suff) const { return _csa.isa[suff]; }
+
+  UINT sa(const UINT rank) const { return _csa[rank]; }
+
+  UINT lcp(const UINT rank) const { return _lcp[rank]; }
+
+  UINT lce_of_ranks(const UINT rank1, const UINT rank2) const {
+    UINT r1 = std::min(rank1, rank2);
+    UINT r2 = std::max(rank1, rank2);
+    return _lcp[_rmq(r1 + 1, r2)];
+  }
+
+  void prefetch_isa(const UINT suff) const { prefetch_isa_of(_csa, suff); }
+
+  //////////////////////// private ////////////////////////
+private:
+  t_csa _csa; //< suffix array and its inverse
+  t_lcp _lcp; //< lcp array
+  t_rmq _rmq; //< data-structure to answer rmq in constant time
+};
+
+/** Index made of plain arrays; the range minima of the LCP array over ranges
+ * of a power of two length are precomputed (sparse table)
+ * **/
+class Fast_search_index : public Search_index {
+
+public:
+  void build(const sdsl::int_vector<> &seq, const UINT num_threads);
+
+  UINT size() const { return _sa.size(); }
+
+  UINT isa(const UINT suff) const { return _isa[suff]; }
+
+  UINT sa(const UINT rank) const { return _sa[rank]; }
+
+  UINT lcp(const UINT rank) const { return _lcp[rank]; }
+
+  UINT lce_of_ranks(const UINT rank1, const UINT rank2) const {
+    UINT r1 = std::min(rank1, rank2);
+    UINT r2 = std::max(rank1, rank2);
+    // Minimum of lcp[r1 + 1 .. r2] from two (overlapping) ranges
+    UINT level = sdsl::bits::hi(r2 - r1);
+    const uint32_t *minima = &_minima[level * _lcp.size()];
+    return std::min(minima[r1 + 1], minima[r2 + 1 - (1ULL << level)]);
+  }
+
+  void prefetch_isa(const UINT suff) const { __builtin_prefetch(&_isa[suff]); }
+
+  void prefetch_ranks(const UINT rank1, const UINT rank2) const {
+    UINT r1 = std::min(rank1, rank2);
+    UINT r2 = std::max(rank1, rank2);
+    UINT level = sdsl::bits::hi(r2 - r1);
+    const uint32_t *minima = &_minima[level * _lcp.size()];
+    __builtin_prefetch(minima + r1 + 1);
+    __builtin_prefetch(minima + r2 + 1 - (1ULL << level));
+  }
+
+  //////////////////////// private ////////////////////////
+private:
+  std::vector<uint32_t> _sa;  //< suffix array
+  std::vector<uint32_t> _isa; //< inverse suffix array
+  std::vector<uint32_t> _lcp; //< lcp array
+  /** Minimum of the lcp array over [i, i + 2^level) at level * n + i; level
+   * 0 is a copy of the lcp array
+   * **/
+  std::vector<uint32_t> _minima;
+};
+
+using Succinct_search_index =
+    Sdsl_search_index<sdsl::csa_bitcompressed<sdsl::int_alphabet<>>,
+                      sdsl::lcp_bitcompressed<>, sdsl::rmq_succinct_sct<>>;
+
+using Compact_search_index = Sdsl_search_index<
+    sdsl::csa_wt<sdsl::wt_int<>, 32, 64, sdsl::sa_order_sa_sampling<>,
+                 sdsl::isa_sampling<>, sdsl::int_alphabet<>>,
+    sdsl::lcp_dac<>, sdsl::rmq_succinct_sct<>>;
+
+/** @brief builds the given index of the given sequence and, if given, the
+ *other index of the other sequence (the reverse), with the given number of
+ *threads in all
+ * With more than one thread, both are built concurrently, with half the
+ *threads each.
+ *
+ **/
+void build_search_indexes(Search_index &index, const sdsl::int_vector<> &seq,
+                          Search_index *other_index,
+                          const sdsl::int_vector<> &other_seq,
+                          const UINT num_threads);
+
+/** @brief returns an (empty) index of the given profile
+ * @see IndexProfile
+ *
+ **/
+std::unique_ptr<Search_index> make_search_index(const IndexProfile profile);
+
+} // end namespace
+#endif
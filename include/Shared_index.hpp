@@ -0,0 +1,110 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Shared_index.hpp
+ * @brief Defines the class Shared_index.
+ * A Shared_index is one index (forward and reverse) of several degenerate
+ * strings, so that the index of each short string need not be built on its
+ * own.
+ * The solid sequences of the strings are combined, each one between two
+ * separators; the separators and the letters substituting the degenerate
+ * symbols are unique in the combined sequence. Hence an lcp query of two
+ * positions of one string has the same answer as in the index of that string
+ * alone.
+ *
+ * Provides methods for the following:
+ * - Getting the forward and reverse indexes, and the position of each string
+ * in the indexed sequences.
+ * - Getting the ranks of the suffixes of each string (in the order of the
+ * forward index); the LPF-array of a string is calculated from them without
+ * looking at the other strings.
+ */
+
+#ifndef SHARED_INDEX_HPP
+#define SHARED_INDEX_HPP
+
+#include "Degenerate_string.hpp"
+#include "Search_index.hpp"
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+class Shared_index {
+
+public:
+  /** @brief Constructor for Class Shared_index: builds the index of the given
+   *strings
+   * The reverse index is built only if the options ask for it (see
+   *BackwardLce); the profile of the indexes is that of the options.
+   * @param strings the degenerate strings
+   * @param options options of the searches that will use the index
+   * @see SearchOptions
+   *
+   **/
+  Shared_index(const std::vector<const Degenerate_string *> &strings,
+               const SearchOptions &options);
+
+  /** @brief returns the index of the combined (forward) sequence
+   *
+   **/
+  const Search_index &get_forward_index() const { return *_fwd_index; }
+
+  /** @brief returns the index of the reverse combined sequence (nullptr if it
+   *is not built)
+   *
+   **/
+  const Search_index *get_reverse_index() const { return _rev_index.get(); }
+
+  /** @brief returns the position of the given string in the combined
+   *sequence
+   *
+   **/
+  UINT get_offset(const UINT str) const { return _offsets[str]; }
+
+  /** @brief returns the position of the reverse of the given string in the
+   *reverse combined sequence
+   *
+   **/
+  UINT get_reverse_offset(const UINT str) const {
+    return _size - _offsets[str] - _lengths[str];
+  }
+
+  /** @brief returns the ranks of the suffixes of all the strings in the
+   *forward index
+   * Those of string s are at [get_rank_offsets()[s], get_rank_offsets()[s +
+   *1]), in ascending order.
+   *
+   **/
+  const std::vector<UINT> &get_ranks() const { return _ranks; }
+
+  /** @brief returns the start of the ranks of each string
+   * @see get_ranks
+   *
+   **/
+  const std::vector<UINT> &get_rank_offsets() const { return _rank_offsets; }
+
+  //////////////////////// private ////////////////////////
+private:
+  std::vector<UINT> _offsets; //< position of each string
+  std::vector<UINT> _lengths; //< length of each string
+  UINT _size;                 //< length of the combined sequence
+  std::unique_ptr<Search_index> _fwd_index; //< index of the sequence
+  std::unique_ptr<Search_index> _rev_index; //< index of its reverse
+  std::vector<UINT> _ranks;        //< ranks of each string (see get_ranks)
+  std::vector<UINT> _rank_offsets; //< start of the ranks of each string
+};
+
+} // end namespace
+#endif
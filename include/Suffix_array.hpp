@@ -0,0 +1,71 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Suffix_array.hpp
+ * @brief Defines the parallel construction of the suffix array and the LCP
+ * array of a sequence (over an integer alphabet).
+ * As in SDSL, the sequence must not contain 0; a 0 is appended to it (the
+ * sentinel), so the arrays have one more entry than the sequence.
+ * - The suffix array is built by prefix doubling: each round sorts the
+ * suffixes by the ranks of their first h and next h symbols (a parallel
+ * sort), until all the ranks are distinct.
+ * - The LCP array is built from the permuted LCP array (by the Phi array);
+ * each thread computes a range of text positions.
+ * - The arrays can be put in a cache of SDSL, so that the data-structures of
+ * SDSL are built from them instead of being built again.
+ */
+
+#ifndef SUFFIX_ARRAY_HPP
+#define SUFFIX_ARRAY_HPP
+
+#include <sdsl/config.hpp>
+#include <sdsl/int_vector.hpp>
+
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+/** @brief constructs the suffix array of the given sequence (and the
+ *sentinel) with the given number of threads
+ * @param seq the sequence
+ * @param num_threads number of threads
+ * @param sa reference to the vector in which the suffix array will be stored
+ *
+ **/
+void construct_suffix_array(const sdsl::int_vector<> &seq,
+                            const UINT num_threads, std::vector<uint32_t> &sa);
+
+/** @brief constructs the LCP array of the given sequence (and the sentinel)
+ *from its suffix array with the given number of threads
+ * @param seq the sequence
+ * @param sa its suffix array
+ * @param num_threads number of threads
+ * @param lcp reference to the vector in which the LCP array will be stored
+ *
+ **/
+void construct_lcp_array(const sdsl::int_vector<> &seq,
+                         const std::vector<uint32_t> &sa,
+                         const UINT num_threads, std::vector<uint32_t> &lcp);
+
+/** @brief constructs the suffix and LCP arrays of the given sequence with the
+ *given number of threads and puts them (with the sequence and the sentinel)
+ *in the given cache of SDSL
+ *
+ **/
+void cache_suffix_arrays(const sdsl::int_vector<> &seq,
+                         const UINT num_threads, sdsl::cache_config &config);
+
+} // end namespace
+#endif
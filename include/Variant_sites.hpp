@@ -0,0 +1,87 @@
+/**
+    degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** @file Variant_sites.hpp
+ * @brief Defines the class Variant_sites.
+ * It holds the sites of SNPs of a VCF file (uncompressed or gzip), by
+ * chromosome. The sequences of a reference FASTA file are parsed with the
+ * sites of their chromosome: the letter at each site becomes a degenerate
+ * symbol of the reference and alternative letters (see Parser), so the
+ * degenerate strings are built without an intermediate file in braces.
+ * - Only the alleles of one letter are taken (SNPs); other alleles (indels,
+ * symbolic or missing ones) are skipped, as are the sites left with a single
+ * letter.
+ * - The sites of one position (e.g. a multiallelic site split over several
+ * lines) are merged.
+ * - The chromosome of a sequence is the first word of its header.
+ */
+
+#ifndef VARIANT_SITES_HPP
+#define VARIANT_SITES_HPP
+
+#include <unordered_map>
+
+#include "Parser.hpp"
+#include "globalDefs.hpp"
+
+namespace deglpf {
+
+class Variant_sites {
+
+public:
+  /** @brief reads the SNPs of the given VCF file (uncompressed or gzip)
+   * @param filename name of the VCF file
+   * @param parser parser of the sequences (encoding the letters of alleles)
+   * @return execution status // SUCCESS if the file is valid, otherwise
+   *corresponding error code after logging the error
+   *
+   **/
+  ReturnStatus read_vcf(const std::string &filename, const Parser &parser);
+
+  /** @brief returns the sites of the given chromosome, in the order of their
+   *positions (nullptr if it has none)
+   *
+   **/
+  const std::vector<Variant_site> *get_sites(const std::string &chrom) const;
+
+  /** @brief returns the sites of the sequence of the given name (header
+   *without '>'), whose first word is its chromosome
+   *
+   **/
+  const std::vector<Variant_site> *
+  get_sites_of_record(const std::string &name) const;
+
+  /** @brief returns the number of the sites of all the chromosomes
+   *
+   **/
+  UINT get_numberof_sites() const;
+
+  //////////////////////// private ////////////////////////
+private:
+  /** sites of each chromosome */
+  std::unordered_map<std::string, std::vector<Variant_site>> _sites;
+
+  /** @brief adds the site of the given fields (POS, REF and ALT) of a line
+   *of the file to the given sites (if it has SNPs)
+   * @return false if the position is not valid
+   *
+   **/
+  bool add_site(std::vector<Variant_site> &sites, const char *pos,
+                const char *ref, const char *ref_end, const char *alt,
+                const char *alt_end, const Parser &parser);
+};
+
+} // end namespace
+#endif
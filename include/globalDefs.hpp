@@ -27,6 +27,7 @@
 #include <string>
 //#include <tuple>
 #include <cassert>
+#include <utility>
 #include <vector>
 
 namespace deglpf {
@@ -34,16 +35,28 @@ namespace deglpf {
 
 using UINT = uint32_t;
 using INT = int64_t;
-using ENCODED_CHAR = u_int8_t;
+using ENCODED_CHAR = UINT;
 
 const std::string cGENAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 const std::string cPROTAlphabet = "ACDEFGHIKLMNPQRSTUVWY";
 const std::string cDegenerate_PROTAlphabet = "ABCDEFGHIJKLMNPQRSTUVWXYZ";
 const std::string cDNAAlphabet = "ACGTU";
 const std::string cDegenerate_DNAAlphabet = "ACGTUNRDHKMSWYVB";
+/** Letters of each ambiguity code (IUPAC) of the DNA alphabet **/
+const std::vector<std::pair<char, std::string>> cDNA_ambiguity_codes = {
+    {'N', "ACGT"}, {'R', "AG"},  {'Y', "CT"},  {'K', "GT"},
+    {'M', "AC"},   {'S', "CG"},  {'W', "AT"},  {'B', "CGT"},
+    {'D', "AGT"},  {'H', "ACT"}, {'V', "ACG"}};
+/** Letters of each ambiguity code (IUPAC) of the Protein alphabet **/
+const std::vector<std::pair<char, std::string>> cPROT_ambiguity_codes = {
+    {'B', "DN"}, {'Z', "EQ"}, {'J', "IL"}, {'X', "ACDEFGHIKLMNPQRSTVWY"}};
 const char cDegenerate_symbol_start = '{';
 const char cDegenerate_symbol_stop = '}';
-const ENCODED_CHAR cMAxUniqueSymbol = 255;
+const UINT cPosition_chunk_size = 64; //< Positions scheduled at once per thread
+const UINT cTable_tile_size = 64;     //< Symbols of the table read together
+const UINT cPrefetch_distance = 8;    //< Reads prefetched ahead of their use
+const UINT cDirect_lce_window = 16; //< Symbols compared before using the index
+const UINT cLCP_batch_size = 256;   //< LCP queries answered together
 
 enum class ReturnStatus {
   SUCCESS,
@@ -57,21 +70,98 @@ enum class ReturnStatus {
 
 enum class AlphabetType { DNA, PROT, GEN };
 
+/** Engine used to fill the table of the longest degenerate prefixes
+ * - ROWS: one symbol at a time, following (iteratively) the chain of the
+ * cells a cell depends on
+ * - DIAGONALS: the cells of a pair of positions depend only on the cells of
+ * the same diagonal; diagonals are filled concurrently
+ * - LAZY: a cell is computed when it is read, following its chain; only the
+ * cells of chains are stored
+ * **/
+enum class FillType { ROWS, DIAGONALS, LAZY };
+
+/** Layout of the table of the longest degenerate prefixes
+ * - SYMBOL_MAJOR: the cells of a symbol (row) are contiguous
+ * - POSITION_MAJOR: the cells of a position (column) are contiguous; TYPE 1
+ * Search reads them for all the preceding symbols
+ * **/
+enum class TableLayout { SYMBOL_MAJOR, POSITION_MAJOR };
+
+/** Data-structures answering the LCP queries on the solid sequence
+ * - SUCCINCT: bit-compressed suffix and LCP arrays with a succinct RMQ
+ * - FAST: plain arrays with a sparse-table RMQ; more memory, quicker queries
+ * - COMPACT: wavelet-tree suffix array with a DAC-encoded LCP array; less
+ * memory, slower queries
+ * **/
+enum class IndexProfile { SUCCINCT, FAST, COMPACT };
+
+/** Answers to the backward extension (longest common suffix) queries of the
+ * Type 2 search
+ * - REVERSE_INDEX: an index of the reverse solid sequence
+ * - Z_ARRAY: no reverse index; per block, the Z-array of the reversed seed
+ * followed by the reversed preceding sequence
+ * **/
+enum class BackwardLce { REVERSE_INDEX, Z_ARRAY };
+
+/** Search for the candidates of Type 1 search in the L-regions
+ * - SCAN: an LCP query for each position of the L-region of each preceding
+ * block, at each position
+ * - BORDERS: one KMP pass of each seed (reversed) over the reversed sequence;
+ * the candidates at a position are the borders of the matched prefix
+ * **/
+enum class LRegionSearch { SCAN, BORDERS };
+
+/** Format of the output file
+ * - TEXT: a block of lines for each sequence (the values of the LPF-array in
+ * decimal)
+ * - BINARY: a record for each sequence with the LPF-array bit-packed, to be
+ * mapped in memory (see Lpf_file)
+ * - IRREDUCIBLE: as BINARY, but with each LPF-array stored by its irreducible
+ * positions (see Irreducible_lpf)
+ * **/
+enum class OutputFormat { TEXT, BINARY, IRREDUCIBLE };
+
+/** Options for the search (calculation of the LPF-array) **/
+struct SearchOptions {
+  UINT num_threads = 1;                //< number of threads used
+  FillType fill_type = FillType::ROWS; //< engine used to fill the table
+  TableLayout table_layout = TableLayout::SYMBOL_MAJOR; //< layout of the table
+  IndexProfile index_profile = IndexProfile::SUCCINCT; //< index for LCP queries
+  BackwardLce backward_lce = BackwardLce::REVERSE_INDEX; //< for Type 2 search
+  LRegionSearch l_region_search = LRegionSearch::SCAN; //< for Type 1 search
+  UINT build_threads = 1; //< threads building the indexes (1: by SDSL)
+};
+
+/** Options of processing the records (sequences) of an input file
+ * @see Pipeline
+ */
+struct PipelineOptions {
+  UINT num_workers = 1; //< number of records processed concurrently
+  UINT max_in_flight = 0; //< records read but not yet written (0: 2 x groups)
+  UINT group_size = 1; //< records sharing one index (1: none is shared)
+  bool print_stats = false; //< print the statistics of each record
+  OutputFormat output_format = OutputFormat::TEXT; //< format of the output
+};
+
 using SEED =
     std::vector<ENCODED_CHAR>; //< A seed is the vector of the encoded character
-using SEEDS = std::vector<SEED>;
-using DEGENERATE_SYMBOL =
-    std::vector<bool>; // 0 or 1 corresponding to each letter of the alphabet in
-                       // accordance with its presence (0=> absent, 1=> present)
-using DEGENERATE_SYMBOLS = std::vector<DEGENERATE_SYMBOL>;
-/** An index structure provides the index to a symbol in a degenerate string (collection of
- * seeds interleaved by the degenerate symbols)
+using SYMBOL_MASK =
+    uint32_t; // bit corresponding to each letter of the alphabet in accordance
+              // with its presence (0=> absent, 1=> present)
+const UINT cMask_bits = 32; //< Letters covered by one word of a symbol mask
+/** All the degenerate symbols stored back to back as fixed-width bitmasks;
+ * one word per symbol for alphabets smaller than cMask_bits, more otherwise
  * **/
-using INDEX = struct Index {
-  bool is_seed;      // true if index is seed, false for the degenerate symbol
-  UINT index;        // index of the seed/degenerate-symbol
-  UINT inseed_index; // index within seed (valid only if the type is seed)
+using DEGENERATE_SYMBOLS = std::vector<SYMBOL_MASK>;
+/** A site of variants (e.g. SNPs of a VCF file) in a sequence **/
+struct Variant_site {
+  UINT pos;         //< position in the sequence (from 0)
+  SYMBOL_MASK mask; //< letters at the site (of the reference and variants)
 };
+/** Flag of an entry of the flat sequence that holds a degenerate symbol; the
+ * remaining bits of the entry give the index of the symbol
+ * **/
+const ENCODED_CHAR cDegenerate_marker = ENCODED_CHAR(1) << 31;
 
 } // end namespace
 
@@ -32,8 +32,12 @@
 namespace deglpf{
 struct InputFlags{
   std::string input_filename;
+  std::string vcf_filename;
+  bool convert_to_text = false; // the input is a binary LPF file
   std::string output_filename;
   AlphabetType alphabet_type;
+  SearchOptions search_options;
+  PipelineOptions pipeline_options;
 };
 
 void usage (void);
@@ -0,0 +1,77 @@
+import random
+import subprocess
+import time
+######### Settings of the benchmark #############
+alphabet = ['A', 'C', 'G', 'T']
+# One sequence is generated for each pair of (length, number of degenerate
+# symbols); few degenerate symbols, so that building the index dominates.
+# It is processed with each number of threads building the index.
+text_size = [1000000, 4000000, 16000000]
+k = [10]
+build_threads = [1, 2, 4, 8]
+# Index profiles compared (see the option '-x')
+indexes = ['succinct', 'fast']
+# Options passed to the tool for every run (e.g. ['-b', 'zarray'])
+tool_options = []
+param_separator = '\t'
+###################################################
+
+FOLDER = './experiments/'
+DATA_FOLDER = 'data/'
+INPUT_FILE_NAME = 'construction_input'
+OUTPUT_FILE_NAME = 'construction_output'
+STATS_FILE_NAME = 'construction_stats.txt'
+
+stats_param = ['n', 'k', 'index', 'build_threads', 'wall_time', 'lpf_time']
+
+
+def write_file(seq_file, seq_size, d):
+    seq = [random.choice(alphabet) for i in range(seq_size)]
+    for pos in random.sample(range(seq_size), d):
+        sym_size = random.randint(2, len(alphabet))
+        seq[pos] = '{' + ''.join(random.sample(alphabet, sym_size)) + '}'
+    seq_file.write('>seq ' + str(seq_size) + '_' + str(d) + '\n')
+    seq_file.write(''.join(seq) + '\n\n')
+
+
+def lpf_time(o_file):
+    # 2nd line of the block: time used for calculation
+    with open(o_file, "r") as f:
+        f.readline()
+        return f.readline().strip()
+
+
+def run(i_file, o_file, index, threads):
+    cmd = ['./bin/degLPF', '-a', 'DNA', '-i', i_file, '-o', o_file, '-x',
+           index, '-p', str(threads)] + tool_options
+    print('COMMAND: ' + ' '.join(cmd))
+    start = time.time()
+    subprocess.run(cmd, stdout=subprocess.DEVNULL)
+    wall = time.time() - start
+    return [str(round(wall, 6)), lpf_time(o_file)]
+
+
+def main():
+    i_filename = FOLDER + DATA_FOLDER + INPUT_FILE_NAME
+    o_filename = FOLDER + DATA_FOLDER + OUTPUT_FILE_NAME
+    sf = open(FOLDER + STATS_FILE_NAME, 'w')
+    sf.write(param_separator.join(stats_param))
+    sf.write('\n')
+
+    for seq_size in text_size:
+        for d in k:
+            suff = str(seq_size) + '_' + str(d) + '.txt'
+            with open(i_filename + suff, 'w') as seq_file:
+                write_file(seq_file, seq_size, d)
+            for index in indexes:
+                for threads in build_threads:
+                    o_file = o_filename + index + str(threads) + suff
+                    stats = run(i_filename + suff, o_file, index, threads)
+                    sf.write(param_separator.join(
+                        [str(seq_size), str(d), index, str(threads)] + stats) +
+                        '\n')
+                    sf.flush()
+    sf.close()
+
+
+main()
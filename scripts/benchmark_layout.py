@@ -0,0 +1,103 @@
+import random
+import re
+import subprocess
+import sys
+import time
+######### Settings of the benchmark #############
+alphabet = ['A', 'C', 'G', 'T']
+# One sequence is generated for each pair of (length, number of degenerate
+# symbols); it is processed with each layout of the table.
+text_size = [4000, 16000, 64000]
+k = [20, 80, 160]
+layouts = ['symbol', 'position']
+# Options passed to the tool for every run (e.g. ['-t', '4'])
+tool_options = []
+# Hardware counters collected via 'perf stat' (if it is available)
+perf_events = 'cache-references,cache-misses'
+param_separator = '\t'
+###################################################
+
+FOLDER = './experiments/'
+DATA_FOLDER = 'data/'
+INPUT_FILE_NAME = 'layout_input'
+OUTPUT_FILE_NAME = 'layout_output'
+STATS_FILE_NAME = 'layout_stats.txt'
+
+stats_param = ['n', 'k', 'layout', 'wall_time', 'lpf_time', 'cache_references',
+               'cache_misses']
+
+
+def write_file(seq_file, seq_size, d):
+    seq = [random.choice(alphabet) for i in range(seq_size)]
+    for pos in random.sample(range(seq_size), d):
+        sym_size = random.randint(2, len(alphabet))
+        seq[pos] = '{' + ''.join(random.sample(alphabet, sym_size)) + '}'
+    seq_file.write('>seq ' + str(seq_size) + '_' + str(d) + '\n')
+    seq_file.write(''.join(seq) + '\n\n')
+
+
+def has_perf():
+    try:
+        subprocess.run(['perf', '--version'], stdout=subprocess.DEVNULL,
+                       stderr=subprocess.DEVNULL)
+        return True
+    except OSError:
+        return False
+
+
+def perf_counter(perf_output, event):
+    match = re.search(r'([\d,]+)\s+' + event, perf_output)
+    if match is None:
+        return 'NA'
+    return match.group(1).replace(',', '')
+
+
+def lpf_time(o_file):
+    # 2nd line of the block: time used for calculation
+    with open(o_file, "r") as f:
+        f.readline()
+        return f.readline().strip()
+
+
+def run(i_file, o_file, layout, use_perf):
+    cmd = ['./bin/degLPF', '-a', 'DNA', '-i', i_file, '-o', o_file, '-l',
+           layout] + tool_options
+    if use_perf:
+        cmd = ['perf', 'stat', '-x', ' ', '-e', perf_events] + cmd
+    print('COMMAND: ' + ' '.join(cmd))
+    start = time.time()
+    comp = subprocess.run(cmd, stdout=subprocess.DEVNULL,
+                          stderr=subprocess.PIPE, universal_newlines=True)
+    wall = time.time() - start
+    refs = misses = 'NA'
+    if use_perf:
+        refs = perf_counter(comp.stderr, 'cache-references')
+        misses = perf_counter(comp.stderr, 'cache-misses')
+    return [str(round(wall, 6)), lpf_time(o_file), refs, misses]
+
+
+def main():
+    use_perf = has_perf()
+    if not use_perf:
+        print('perf is not available: only the times are collected')
+    i_filename = FOLDER + DATA_FOLDER + INPUT_FILE_NAME
+    o_filename = FOLDER + DATA_FOLDER + OUTPUT_FILE_NAME
+    sf = open(FOLDER + STATS_FILE_NAME, 'w')
+    sf.write(param_separator.join(stats_param))
+    sf.write('\n')
+
+    for seq_size in text_size:
+        for d in k:
+            suff = str(seq_size) + '_' + str(d) + '.txt'
+            with open(i_filename + suff, 'w') as seq_file:
+                write_file(seq_file, seq_size, d)
+            for layout in layouts:
+                stats = run(i_filename + suff, o_filename + layout + suff,
+                            layout, use_perf)
+                sf.write(param_separator.join([str(seq_size), str(d), layout] +
+                                              stats) + '\n')
+                sf.flush()
+    sf.close()
+
+
+main()
@@ -20,68 +20,102 @@
 namespace deglpf {
 
 Degenerate_string::Degenerate_string(const UINT as)
-    : _cAlphabet_size(as), _length(0) {}
+    : _cAlphabet_size(as), _cMask_words(as / cMask_bits + 1), _length(0) {}
 
 void Degenerate_string::add_seed(SEED const &seed) {
-  _seeds.push_back(std::move(seed));
+  _seed_offsets.push_back(_length);
+  _symbols.insert(_symbols.end(), seed.begin(), seed.end());
   _length += seed.size();
 }
 
 void Degenerate_string::add_degenerate_symbol(
     std::vector<ENCODED_CHAR> const &deg) {
-  DEGENERATE_SYMBOL ds(_cAlphabet_size + 1, false);
+  auto first = _degenerate_symbols.size();
+  _degenerate_symbols.resize(first + _cMask_words, 0);
   for (auto l : deg) {
-    ds[l] = true;
+    _degenerate_symbols[first + l / cMask_bits] |= SYMBOL_MASK(1)
+                                                   << (l % cMask_bits);
   }
-  _degenerate_symbols.push_back(std::move(ds));
+  _symbols.push_back(cDegenerate_marker | _degenerate_indices.size());
   _degenerate_indices.push_back(_length);
   ++_length;
 }
 
-UINT Degenerate_string::get_numberof_seeds() const { return _seeds.size(); }
+void Degenerate_string::add_degenerate_symbol(const SYMBOL_MASK mask) {
+  _degenerate_symbols.resize(_degenerate_symbols.size() + _cMask_words, 0);
+  _degenerate_symbols[_degenerate_symbols.size() - _cMask_words] = mask;
+  _symbols.push_back(cDegenerate_marker | _degenerate_indices.size());
+  _degenerate_indices.push_back(_length);
+  ++_length;
+}
+
+UINT Degenerate_string::get_numberof_seeds() const {
+  return _seed_offsets.size();
+}
 
 UINT Degenerate_string::get_size() const { return _length; }
 
 UINT Degenerate_string::get_alphabet_size() const { return _cAlphabet_size; }
 
-const SEEDS &Degenerate_string::get_seeds() const { return _seeds; }
+const std::vector<ENCODED_CHAR> &Degenerate_string::get_symbols() const {
+  return _symbols;
+}
+
+const std::vector<UINT> &Degenerate_string::get_seed_offsets() const {
+  return _seed_offsets;
+}
 
 const DEGENERATE_SYMBOLS &Degenerate_string::get_degenerate_symbols() const { return _degenerate_symbols; }
 
+UINT Degenerate_string::get_mask_words() const { return _cMask_words; }
+
+bool Degenerate_string::has_letter(UINT symb, ENCODED_CHAR letter) const {
+  return (_degenerate_symbols[symb * _cMask_words + letter / cMask_bits] >>
+          (letter % cMask_bits)) & 1;
+}
+
 const std::vector<UINT> &Degenerate_string::get_degenerate_indices() const {
   return _degenerate_indices;
 }
 
 // Assumes valid Index and non-empty seed
 ENCODED_CHAR Degenerate_string::get_seed_lastletter(UINT ind) const {
-  assert(ind < _length);
-  assert(!_seeds[ind].empty());
-  auto last = _seeds[ind].size() - 1;
-  return _seeds[ind][last];
+  assert(ind < _seed_offsets.size());
+  auto stop =
+      (ind < _degenerate_indices.size()) ? (_degenerate_indices[ind]) : (_length);
+  assert(stop > _seed_offsets[ind]);
+  return _symbols[stop - 1];
 }
 
-// Assumes valid Indexes
-bool Degenerate_string::is_match(INDEX ind1, INDEX ind2) const {
-  assert(ind1.index < _length);
-  assert(ind2.index < _length);
+// Assumes valid positions
+bool Degenerate_string::is_match(UINT pos1, UINT pos2) const {
+  assert(pos1 < _length);
+  assert(pos2 < _length);
+  auto letter1 = _symbols[pos1];
+  auto letter2 = _symbols[pos2];
   bool result = false;
-  if (ind1.is_seed && ind2.is_seed) {
-    auto letter1 = _seeds[ind1.index][ind1.inseed_index];
-    auto letter2 = _seeds[ind2.index][ind2.inseed_index];
+  bool is_deg1 = (letter1 & cDegenerate_marker) != 0;
+  bool is_deg2 = (letter2 & cDegenerate_marker) != 0;
+  if (!is_deg1 && !is_deg2) {
     result = letter1 == letter2;
-  } else if (ind1.is_seed && !ind2.is_seed) {
-    auto letter1 = _seeds[ind1.index][ind1.inseed_index];
-    result = _degenerate_symbols[ind2.index][letter1];
-  } else if (!ind1.is_seed && ind2.is_seed) {
-    auto letter2 = _seeds[ind2.index][ind2.inseed_index];
-    result = _degenerate_symbols[ind1.index][letter2];
-  } else if (!ind1.is_seed && !ind2.is_seed) {
-    for (auto i = 0; i < _cAlphabet_size; ++i) {
-      if (_degenerate_symbols[ind1.index][i] &&
-          _degenerate_symbols[ind2.index][i]) {
-        result = true;
-        break;
+  } else if (!is_deg1 && is_deg2) {
+    result = has_letter(letter2 & ~cDegenerate_marker, letter1);
+  } else if (is_deg1 && !is_deg2) {
+    result = has_letter(letter1 & ~cDegenerate_marker, letter2);
+  } else {
+    // Symbols match if they share a letter: AND of their masks
+    const SYMBOL_MASK *mask1 =
+        &_degenerate_symbols[(letter1 & ~cDegenerate_marker) * _cMask_words];
+    const SYMBOL_MASK *mask2 =
+        &_degenerate_symbols[(letter2 & ~cDegenerate_marker) * _cMask_words];
+    if (_cMask_words == 1) {
+      result = (*mask1 & *mask2) != 0;
+    } else {
+      SYMBOL_MASK common = 0;
+      for (UINT w = 0; w < _cMask_words; ++w) {
+        common |= mask1[w] & mask2[w];
       }
+      result = common != 0;
     }
   }
   return result;
@@ -0,0 +1,305 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements classes Chunk_queue, Gz_istream and Gz_ostream
+ */
+#include "../include/Gz_stream.hpp"
+
+#include <algorithm>
+
+namespace deglpf {
+
+namespace {
+const UINT cGz_chunk_size = 1 << 20; // bytes passed to or from a helper
+const UINT cGz_queue_chunks = 4;     // chunks between a stream and its helper
+// Data in a BGZF block (so that even stored, the block is within 64 KB)
+const UINT cBgzf_block_data = 0xff00;
+const UINT cBgzf_header_size = 18;
+const UINT cBgzf_footer_size = 8;
+// The empty block at the end of a BGZF file
+const unsigned char cBgzf_eof[] = {
+    0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0x06, 0x00, 0x42, 0x43, 0x02, 0x00, 0x1b, 0x00, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+void put_le(unsigned char *p, const uint32_t value, const UINT bytes) {
+  for (UINT b = 0; b < bytes; ++b) {
+    p[b] = (value >> (8 * b)) & 0xff;
+  }
+}
+
+// Compresses the data into one BGZF block (a gzip member with the size of
+// the block in an extra field); returns the size of the block, 0 if the data
+// could not be compressed
+UINT bgzf_block(z_stream &stream, const char *data, const UINT size,
+                unsigned char *block) {
+  const UINT max_deflated = 0x10000 - cBgzf_header_size - cBgzf_footer_size;
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+  stream.avail_in = size;
+  stream.next_out = block + cBgzf_header_size;
+  stream.avail_out = max_deflated;
+  // The data is small enough that even incompressible, it fits (in stored
+  // blocks of deflate)
+  int status = deflate(&stream, Z_FINISH);
+  UINT deflated = max_deflated - stream.avail_out;
+  deflateReset(&stream);
+  if (status != Z_STREAM_END) {
+    return 0;
+  }
+  UINT block_size = cBgzf_header_size + deflated + cBgzf_footer_size;
+  std::copy(cBgzf_eof, cBgzf_eof + 16, block); // the same header
+  put_le(block + 16, block_size - 1, 2);
+  unsigned char *footer = block + cBgzf_header_size + deflated;
+  put_le(footer, crc32(crc32(0L, Z_NULL, 0),
+                       reinterpret_cast<const Bytef *>(data), size),
+         4);
+  put_le(footer + 4, size, 4);
+  return block_size;
+}
+} // end anonymous namespace
+
+//////////////////////// Chunk_queue ////////////////////////
+
+bool Chunk_queue::push(std::string &chunk) {
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _popped.wait(lock,
+                 [this] { return _closed || _chunks.size() < _capacity; });
+    if (_closed) {
+      return false;
+    }
+    _chunks.push_back(std::move(chunk));
+  }
+  chunk.clear();
+  _pushed.notify_one();
+  return true;
+}
+
+bool Chunk_queue::pop(std::string &chunk) {
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _pushed.wait(lock, [this] { return _closed || !_chunks.empty(); });
+    if (_chunks.empty()) {
+      return false;
+    }
+    chunk = std::move(_chunks.front());
+    _chunks.pop_front();
+  }
+  _popped.notify_one();
+  return true;
+}
+
+void Chunk_queue::close() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+  }
+  _pushed.notify_all();
+  _popped.notify_all();
+}
+
+//////////////////////// Gz_istreambuf ////////////////////////
+
+Gz_istreambuf::Gz_istreambuf(gzFile file)
+    : _file(file), _queue(cGz_queue_chunks),
+      _helper(&Gz_istreambuf::decompress, this) {}
+
+Gz_istreambuf::~Gz_istreambuf() {
+  _queue.close(); // the helper stops at its next chunk
+  _helper.join();
+  gzclose(_file);
+}
+
+Gz_istreambuf::int_type Gz_istreambuf::underflow() {
+  if (!_queue.pop(_chunk)) {
+    return traits_type::eof();
+  }
+  char *data = &_chunk[0];
+  setg(data, data, data + _chunk.size());
+  return traits_type::to_int_type(*gptr());
+}
+
+void Gz_istreambuf::decompress() {
+  std::string chunk;
+  while (true) {
+    chunk.resize(cGz_chunk_size);
+    int count = gzread(_file, &chunk[0], chunk.size());
+    if (count < 0) {
+      int errnum;
+      std::cerr << "Cannot decompress input file: " << gzerror(_file, &errnum)
+                << std::endl;
+      break;
+    }
+    if (count == 0) {
+      break; // end of the file
+    }
+    chunk.resize(count);
+    if (!_queue.push(chunk)) {
+      break; // the stream is destroyed
+    }
+  }
+  _queue.close();
+}
+
+//////////////////////// Gz_ostreambuf ////////////////////////
+
+Gz_ostreambuf::Gz_ostreambuf(std::FILE *file, const bool compressed)
+    : _file(file), _queue(cGz_queue_chunks), _compressed(compressed),
+      _helper(&Gz_ostreambuf::compress, this) {
+  _chunk.resize(cGz_chunk_size);
+  setp(&_chunk[0], &_chunk[0] + _chunk.size());
+}
+
+Gz_ostreambuf::~Gz_ostreambuf() { close(); }
+
+ReturnStatus Gz_ostreambuf::close() {
+  if (_file == nullptr) {
+    return (_error) ? (ReturnStatus::ERR_FILE_OPEN) : (ReturnStatus::SUCCESS);
+  }
+  hand_over();
+  _queue.close();
+  _helper.join();
+  if (_compressed && std::fwrite(cBgzf_eof, 1, sizeof(cBgzf_eof), _file) !=
+                         sizeof(cBgzf_eof)) {
+    _error = true;
+  }
+  if (std::fclose(_file) != 0) {
+    _error = true;
+  }
+  _file = nullptr;
+  if (_error) {
+    std::cerr << "Cannot write output file \n";
+    return ReturnStatus::ERR_FILE_OPEN;
+  }
+  return ReturnStatus::SUCCESS;
+}
+
+Gz_ostreambuf::int_type Gz_ostreambuf::overflow(int_type c) {
+  if (_file == nullptr) {
+    return traits_type::eof();
+  }
+  hand_over();
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int Gz_ostreambuf::sync() {
+  if (_file == nullptr) {
+    return -1;
+  }
+  hand_over();
+  return 0;
+}
+
+void Gz_ostreambuf::hand_over() {
+  if (pptr() == pbase()) {
+    return;
+  }
+  _chunk.resize(pptr() - pbase());
+  _queue.push(_chunk); // leaves the chunk empty
+  _chunk.resize(cGz_chunk_size);
+  setp(&_chunk[0], &_chunk[0] + _chunk.size());
+}
+
+void Gz_ostreambuf::compress() {
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  // Raw deflate: the header and footer of each block are written here
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+               Z_DEFAULT_STRATEGY);
+  std::vector<unsigned char> block(0x10000);
+  std::string chunk;
+  while (_queue.pop(chunk)) {
+    if (_error) {
+      continue; // drain the queue
+    }
+    if (!_compressed) {
+      _error = std::fwrite(chunk.data(), 1, chunk.size(), _file) != chunk.size();
+      continue;
+    }
+    for (UINT start = 0; start < chunk.size(); start += cBgzf_block_data) {
+      UINT size = std::min<UINT>(cBgzf_block_data, chunk.size() - start);
+      UINT block_size = bgzf_block(stream, chunk.data() + start, size,
+                                   block.data());
+      if (block_size == 0 ||
+          std::fwrite(block.data(), 1, block_size, _file) != block_size) {
+        _error = true;
+        break;
+      }
+    }
+  }
+  deflateEnd(&stream);
+}
+
+//////////////////////// Gz_istream ////////////////////////
+
+ReturnStatus Gz_istream::open(const std::string &filename) {
+  gzFile file = gzopen(filename.c_str(), "rb");
+  if (file == nullptr) {
+    return ReturnStatus::ERR_FILE_OPEN;
+  }
+  gzbuffer(file, cGz_chunk_size);
+  _buf.reset(new Gz_istreambuf(file));
+  rdbuf(_buf.get());
+  clear();
+  return ReturnStatus::SUCCESS;
+}
+
+bool Gz_istream::is_compressed(const char *begin, const char *end) {
+  return end - begin >= 2 && static_cast<unsigned char>(begin[0]) == 0x1f &&
+         static_cast<unsigned char>(begin[1]) == 0x8b;
+}
+
+//////////////////////// Gz_ostream ////////////////////////
+
+ReturnStatus Gz_ostream::open(const std::string &filename,
+                              const bool compressed) {
+  std::FILE *file = std::fopen(filename.c_str(), "wb");
+  if (file == nullptr) {
+    return ReturnStatus::ERR_FILE_OPEN;
+  }
+  _buf.reset(new Gz_ostreambuf(file, compressed));
+  rdbuf(_buf.get());
+  clear();
+  return ReturnStatus::SUCCESS;
+}
+
+ReturnStatus Gz_ostream::close() {
+  if (_buf == nullptr) {
+    return ReturnStatus::SUCCESS;
+  }
+  ReturnStatus status = _buf->close();
+  rdbuf(nullptr);
+  _buf.reset();
+  return status;
+}
+
+bool Gz_ostream::is_compressed_name(const std::string &filename) {
+  for (std::string suffix : {".gz", ".bgz"}) {
+    if (filename.size() >= suffix.size() &&
+        filename.compare(filename.size() - suffix.size(), suffix.size(),
+                         suffix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // end namespace
@@ -0,0 +1,154 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements class Irreducible_lpf
+ */
+#include "../include/Irreducible_lpf.hpp"
+
+#include <algorithm>
+#include <streambuf>
+#include <utility>
+
+namespace deglpf {
+
+namespace {
+// Read-only stream buffer over the given memory (e.g. a mapped file)
+class Memory_buf : public std::streambuf {
+public:
+  Memory_buf(const char *begin, const char *end) {
+    setg(const_cast<char *>(begin), const_cast<char *>(begin),
+         const_cast<char *>(end));
+  }
+
+  // Number of the bytes read
+  uint64_t consumed() const { return gptr() - eback(); }
+};
+
+// Positions i > 0 with LPF[i] != LPF[i-1] - 1, and 0
+void find_irreducible(const std::vector<UINT> &lpf,
+                      std::vector<UINT> &positions) {
+  positions.clear();
+  for (UINT i = 0; i < lpf.size(); ++i) {
+    if (i == 0 || Irreducible_lpf::is_irreducible(lpf, i)) {
+      positions.push_back(i);
+    }
+  }
+}
+} // end anonymous namespace
+
+Irreducible_lpf::Irreducible_lpf(const std::vector<UINT> &lpf) {
+  std::vector<UINT> positions;
+  find_irreducible(lpf, positions);
+  *this = Irreducible_lpf(lpf, positions);
+}
+
+Irreducible_lpf::Irreducible_lpf(const std::vector<UINT> &lpf,
+                                 const std::vector<UINT> &positions) {
+  if (lpf.empty()) {
+    bind();
+    return;
+  }
+  sdsl::sd_vector_builder builder(lpf.size(), positions.size());
+  UINT max_value = 0;
+  for (auto p : positions) {
+    builder.set(p);
+    max_value = std::max(max_value, lpf[p]);
+  }
+  _starts = sdsl::sd_vector<>(builder);
+  uint8_t width = (max_value == 0) ? (1) : (sdsl::bits::hi(max_value) + 1);
+  _values = sdsl::int_vector<>(positions.size(), 0, width);
+  for (UINT j = 0; j < positions.size(); ++j) {
+    _values[j] = lpf[positions[j]];
+  }
+  bind();
+}
+
+Irreducible_lpf::Irreducible_lpf(const Irreducible_lpf &other)
+    : _starts(other._starts), _values(other._values) {
+  bind();
+}
+
+Irreducible_lpf &Irreducible_lpf::operator=(const Irreducible_lpf &other) {
+  if (this != &other) {
+    _starts = other._starts;
+    _values = other._values;
+    bind();
+  }
+  return *this;
+}
+
+Irreducible_lpf::Irreducible_lpf(Irreducible_lpf &&other) {
+  *this = std::move(other);
+}
+
+Irreducible_lpf &Irreducible_lpf::operator=(Irreducible_lpf &&other) {
+  if (this != &other) {
+    _starts = std::move(other._starts);
+    _values = std::move(other._values);
+    bind();
+    other._starts = sdsl::sd_vector<>();
+    other._values = sdsl::int_vector<>();
+    other.bind();
+  }
+  return *this;
+}
+
+void Irreducible_lpf::get_lpf(std::vector<UINT> &lpf) const {
+  UINT n = size();
+  lpf.resize(n);
+  // Each run goes down from its irreducible position to the next one
+  for (UINT j = 0; j < _values.size(); ++j) {
+    UINT begin = _select(j + 1);
+    UINT end = (j + 1 < _values.size()) ? (_select(j + 2)) : (n);
+    UINT value = _values[j];
+    for (UINT i = begin; i < end; ++i) {
+      lpf[i] = value--;
+    }
+  }
+}
+
+uint64_t Irreducible_lpf::size_in_bytes() const {
+  return sdsl::size_in_bytes(_starts) + sdsl::size_in_bytes(_values);
+}
+
+uint64_t Irreducible_lpf::serialize(std::ostream &out) const {
+  return _starts.serialize(out) + _values.serialize(out);
+}
+
+ReturnStatus Irreducible_lpf::load(const char *begin, const char *end) {
+  Memory_buf buf(begin, end);
+  std::istream in(&buf);
+  _starts.load(in);
+  _values.load(in);
+  bind();
+  // Each irreducible position has its value, the first one at 0
+  if (!in ||
+      buf.consumed() != static_cast<uint64_t>(end - begin) ||
+      (size() == 0 && _values.size() != 0) ||
+      (size() > 0 && (_values.size() == 0 || _values.size() != _rank(size()) ||
+                      _select(1) != 0))) {
+    *this = Irreducible_lpf();
+    return ReturnStatus::ERR_INVALID_INPUT;
+  }
+  return ReturnStatus::SUCCESS;
+}
+
+//////////////////////// private ////////////////////////
+void Irreducible_lpf::bind() {
+  _rank.set_vector(&_starts);
+  _select.set_vector(&_starts);
+}
+
+} // end namespace
@@ -0,0 +1,323 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements the formats of the output file and class Lpf_reader
+ */
+#include "../include/Lpf_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace deglpf {
+
+namespace {
+const UINT cLpf_header_size = 32; // n, k, time and width
+const UINT cText_chunk_values = 1 << 16; // values formatted by one thread
+
+// Decimal digits of the numbers from 00 to 99, two by two
+const char cDigit_pairs[] = "00010203040506070809"
+                            "10111213141516171819"
+                            "20212223242526272829"
+                            "30313233343536373839"
+                            "40414243444546474849"
+                            "50515253545556575859"
+                            "60616263646566676869"
+                            "70717273747576777879"
+                            "80818283848586878889"
+                            "90919293949596979899";
+
+// Number of the decimal digits of the given value
+UINT num_digits(const UINT value) {
+  return 1 + (value >= 10) + (value >= 100) + (value >= 1000) +
+         (value >= 10000) + (value >= 100000) + (value >= 1000000) +
+         (value >= 10000000) + (value >= 100000000) + (value >= 1000000000);
+}
+
+// Writes the decimal digits of the given value so that they end before end
+void format_uint(UINT value, char *end) {
+  while (value >= 100) {
+    UINT pair = (value % 100) * 2;
+    value /= 100;
+    *--end = cDigit_pairs[pair + 1];
+    *--end = cDigit_pairs[pair];
+  }
+  if (value >= 10) {
+    *--end = cDigit_pairs[value * 2 + 1];
+    *--end = cDigit_pairs[value * 2];
+  } else {
+    *--end = static_cast<char>('0' + value);
+  }
+}
+
+// Finds the offset of each chunk of values (a chunk per thread at a time)
+// in their text, each value followed by a space; returns the size of the text
+uint64_t find_chunk_offsets(const std::vector<UINT> &values,
+                            const UINT num_threads,
+                            std::vector<uint64_t> &chunk_offsets) {
+  INT num_chunks = (values.size() + cText_chunk_values - 1) / cText_chunk_values;
+  chunk_offsets.assign(num_chunks + 1, 0);
+#pragma omp parallel for num_threads(num_threads) if (num_chunks > 1)
+  for (INT c = 0; c < num_chunks; ++c) {
+    UINT end = std::min<uint64_t>(values.size(),
+                                  static_cast<uint64_t>(c + 1) *
+                                      cText_chunk_values);
+    uint64_t num_bytes = 0;
+    for (UINT i = c * cText_chunk_values; i < end; ++i) {
+      num_bytes += num_digits(values[i]) + 1;
+    }
+    chunk_offsets[c + 1] = num_bytes;
+  }
+  for (INT c = 0; c < num_chunks; ++c) {
+    chunk_offsets[c + 1] += chunk_offsets[c];
+  }
+  return chunk_offsets[num_chunks];
+}
+
+// Formats the values, each followed by a space, from text on; each thread
+// formats a chunk of values at a time, at its offset
+void format_values(const std::vector<UINT> &values, const UINT num_threads,
+                   const std::vector<uint64_t> &chunk_offsets, char *text) {
+  INT num_chunks = chunk_offsets.size() - 1;
+#pragma omp parallel for num_threads(num_threads) if (num_chunks > 1)
+  for (INT c = 0; c < num_chunks; ++c) {
+    UINT end = std::min<uint64_t>(values.size(),
+                                  static_cast<uint64_t>(c + 1) *
+                                      cText_chunk_values);
+    char *p = text + chunk_offsets[c];
+    for (UINT i = c * cText_chunk_values; i < end; ++i) {
+      p += num_digits(values[i]);
+      format_uint(values[i], p);
+      *p++ = ' ';
+    }
+  }
+}
+
+uint64_t padded(const uint64_t size) { return (size + 7) & ~uint64_t(7); }
+
+void put_uint64(std::ostream &out, const uint64_t value) {
+  char bytes[8];
+  for (UINT b = 0; b < 8; ++b) {
+    bytes[b] = static_cast<char>((value >> (8 * b)) & 0xff);
+  }
+  out.write(bytes, 8);
+}
+
+uint64_t get_uint64(const char *p) {
+  uint64_t value = 0;
+  for (UINT b = 0; b < 8; ++b) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(p[b])) << (8 * b);
+  }
+  return value;
+}
+
+// Magic, name and header of a record of the binary format
+void write_header(std::ostream &out, const char *magic, const std::string &name,
+                  const UINT size, const UINT num_symbols,
+                  const double exec_time, const uint8_t width) {
+  out.write(magic, 4);
+  char length[4];
+  for (UINT b = 0; b < 4; ++b) {
+    length[b] = static_cast<char>((name.size() >> (8 * b)) & 0xff);
+  }
+  out.write(length, 4);
+  std::string padded_name(name);
+  padded_name.resize(padded(name.size()), '\0');
+  out.write(padded_name.data(), padded_name.size());
+  put_uint64(out, size);
+  put_uint64(out, num_symbols);
+  uint64_t time_bits;
+  std::memcpy(&time_bits, &exec_time, sizeof(time_bits));
+  put_uint64(out, time_bits);
+  put_uint64(out, width);
+}
+} // end anonymous namespace
+
+void write_text_record(std::string &out, const std::string &name,
+                       const double exec_time, const UINT num_symbols,
+                       const std::vector<UINT> &lpf,
+                       const UINT num_threads) {
+  std::ostringstream header;
+  // First line of a block: > followed by the sequence name
+  header << ">" << name << "\n";
+  // Next line of the block: Execution time (in sec)
+  header << exec_time << "\n";
+  // Next line: values of sequence size and number of degenerate symbols
+  // (deleimited by a space)
+  header << lpf.size() << " " << num_symbols << "\n";
+  // Next line: lpf array : each cell deleimited by a space (formatted in
+  // place, once the size of the block is known)
+  std::vector<uint64_t> chunk_offsets;
+  uint64_t num_bytes = find_chunk_offsets(lpf, num_threads, chunk_offsets);
+  std::string header_text = header.str();
+  out.reserve(out.size() + header_text.size() + num_bytes + 2);
+  out += header_text;
+  uint64_t values_begin = out.size();
+  out.resize(values_begin + num_bytes);
+  format_values(lpf, num_threads, chunk_offsets, &out[0] + values_begin);
+  out += "\n";
+  // The block ends with an empty line to delimit it from the following
+  // block
+  out += "\n";
+}
+
+void write_binary_record(std::ostream &out, const std::string &name,
+                         const double exec_time, const UINT num_symbols,
+                         const std::vector<UINT> &lpf) {
+  UINT max_lpf = lpf.empty() ? 0 : *std::max_element(lpf.begin(), lpf.end());
+  uint8_t width = (max_lpf == 0) ? (1) : (sdsl::bits::hi(max_lpf) + 1);
+  sdsl::int_vector<> packed(lpf.size(), 0, width);
+  std::copy(lpf.begin(), lpf.end(), packed.begin());
+
+  write_header(out, cLpf_record_magic, name, lpf.size(), num_symbols,
+               exec_time, width);
+  // The words as they are in memory (little endian)
+  UINT num_words = (static_cast<uint64_t>(lpf.size()) * width + 63) / 64;
+  out.write(reinterpret_cast<const char *>(packed.data()), num_words * 8);
+}
+
+void write_irreducible_record(std::ostream &out, const std::string &name,
+                              const double exec_time, const UINT num_symbols,
+                              const Irreducible_lpf &lpf) {
+  std::ostringstream array;
+  uint64_t num_bytes = lpf.serialize(array);
+  UINT max_lpf = 0;
+  for (UINT j = 0; j < lpf.get_numberof_irreducible(); ++j) {
+    max_lpf = std::max(max_lpf, lpf.get_irreducible_value(j));
+  }
+  uint8_t width = (max_lpf == 0) ? (1) : (sdsl::bits::hi(max_lpf) + 1);
+  write_header(out, cLpf_irreducible_magic, name, lpf.size(), num_symbols,
+               exec_time, width);
+  put_uint64(out, num_bytes);
+  std::string data = array.str();
+  data.resize(padded(num_bytes), '\0');
+  out.write(data.data(), data.size());
+}
+
+void Lpf_record::get_lpf(std::vector<UINT> &lpf) const {
+  lpf.resize(size);
+  for (UINT i = 0; i < size; ++i) {
+    lpf[i] = (*this)[i];
+  }
+}
+
+ReturnStatus Lpf_reader::open(const std::string &filename) {
+  if (_file.open(filename) != ReturnStatus::SUCCESS) {
+    std::cerr << "Cannot open LPF file \n";
+    return ReturnStatus::ERR_FILE_OPEN;
+  }
+  if (_file.end() - _file.begin() < static_cast<INT>(sizeof(cLpf_file_magic)) ||
+      !std::equal(cLpf_file_magic, cLpf_file_magic + sizeof(cLpf_file_magic),
+                  _file.begin())) {
+    std::cerr << "Invalid Input: Not a binary LPF file." << std::endl;
+    return ReturnStatus::ERR_INVALID_INPUT;
+  }
+  _next = _file.begin() + sizeof(cLpf_file_magic);
+  return ReturnStatus::SUCCESS;
+}
+
+ReturnStatus Lpf_reader::next(Lpf_record &record) {
+  const char *end = _file.end();
+  if (_next == end) {
+    return ReturnStatus::ERR_LIMIT_EXCEEDS;
+  }
+  auto invalid = []() {
+    std::cerr << "Invalid Input: Truncated or invalid LPF record."
+              << std::endl;
+    return ReturnStatus::ERR_INVALID_INPUT;
+  };
+  if (end - _next < 8) {
+    return invalid();
+  }
+  record.is_irreducible = std::equal(
+      cLpf_irreducible_magic,
+      cLpf_irreducible_magic + sizeof(cLpf_irreducible_magic), _next);
+  if (!record.is_irreducible &&
+      !std::equal(cLpf_record_magic,
+                  cLpf_record_magic + sizeof(cLpf_record_magic), _next)) {
+    return invalid();
+  }
+  UINT name_length = get_uint64(_next) >> 32;
+  const char *p = _next + 8;
+  if (static_cast<uint64_t>(end - p) < padded(name_length) + cLpf_header_size) {
+    return invalid();
+  }
+  record.name.assign(p, name_length);
+  p += padded(name_length);
+  uint64_t size = get_uint64(p);
+  uint64_t num_symbols = get_uint64(p + 8);
+  uint64_t time_bits = get_uint64(p + 16);
+  uint64_t width = get_uint64(p + 24);
+  p += cLpf_header_size;
+  if (width == 0 || width > 32 || size > UINT(-1)) {
+    return invalid();
+  }
+  uint64_t num_bytes; // of the array
+  if (record.is_irreducible) {
+    if (end - p < 8) {
+      return invalid();
+    }
+    num_bytes = get_uint64(p);
+    p += 8;
+    if (num_bytes > static_cast<uint64_t>(end - p) ||
+        padded(num_bytes) > static_cast<uint64_t>(end - p) ||
+        record.irreducible.load(p, p + num_bytes) != ReturnStatus::SUCCESS ||
+        record.irreducible.size() != size) {
+      return invalid();
+    }
+    num_bytes = padded(num_bytes);
+    record.words = nullptr;
+  } else {
+    num_bytes = (size * width + 63) / 64 * 8;
+    if (static_cast<uint64_t>(end - p) < num_bytes) {
+      return invalid();
+    }
+    record.words = reinterpret_cast<const uint64_t *>(p);
+  }
+  record.size = size;
+  record.num_symbols = num_symbols;
+  std::memcpy(&record.exec_time, &time_bits, sizeof(time_bits));
+  record.width = width;
+  _next = p + num_bytes;
+  return ReturnStatus::SUCCESS;
+}
+
+ReturnStatus convert_to_text(const std::string &filename, std::ostream &out) {
+  Lpf_reader reader;
+  ReturnStatus status = reader.open(filename);
+  if (status != ReturnStatus::SUCCESS) {
+    return status;
+  }
+  return convert_to_text(reader, out);
+}
+
+ReturnStatus convert_to_text(Lpf_reader &reader, std::ostream &out) {
+  ReturnStatus status;
+  Lpf_record record;
+  std::vector<UINT> lpf;
+  std::string text; // of a record
+  while ((status = reader.next(record)) == ReturnStatus::SUCCESS) {
+    record.get_lpf(lpf);
+    text.clear();
+    write_text_record(text, record.name, record.exec_time, record.num_symbols,
+                      lpf);
+    out.write(text.data(), text.size());
+  }
+  out.flush();
+  return (status == ReturnStatus::ERR_LIMIT_EXCEEDS) ? (ReturnStatus::SUCCESS)
+                                                     : (status);
+}
+
+} // end namespace
@@ -0,0 +1,59 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements class Mapped_file
+ */
+#include "../include/Mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace deglpf {
+
+Mapped_file::~Mapped_file() {
+  if (_size > 0) {
+    munmap(const_cast<char *>(_data), _size);
+  }
+}
+
+ReturnStatus Mapped_file::open(const std::string &filename) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return ReturnStatus::ERR_FILE_OPEN;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return ReturnStatus::ERR_FILE_OPEN;
+  }
+  _size = st.st_size;
+  if (_size > 0) { // an empty file cannot be mapped (nor needs to be)
+    void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      _size = 0;
+      return ReturnStatus::ERR_FILE_OPEN;
+    }
+    // Read once from start to end
+    madvise(data, _size, MADV_SEQUENTIAL);
+    _data = static_cast<const char *>(data);
+  }
+  close(fd);
+  return ReturnStatus::SUCCESS;
+}
+
+} // end namespace
@@ -17,65 +17,207 @@
  */
 #include "../include/Parser.hpp"
 
+#include <cctype>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace deglpf {
-Parser::Parser(const AlphabetType alphabetType, const std::string &alphabet)
-    : _cAlphabetType(alphabetType), _cAlphabet(alphabet) {}
 
-ReturnStatus Parser::parse_sequence(std::ifstream &infile,
-                                    Degenerate_string &dgs) const {
-  FCheckValidity fCheckValidity = &Parser::is_valid_char_general;
-  FMapChar fMapChar = &Parser::map_char_general;
+namespace {
+// Whether the character is a whitespace, a brace, or not ASCII: the
+// characters that end a run of letters
+bool is_special(const char c) {
+  return static_cast<signed char>(c) <= ' ' || c == cDegenerate_symbol_start ||
+         c == cDegenerate_symbol_stop;
+}
+
+// First special character in [p, end) (end if there is none)
+const char *find_special(const char *p, const char *end) {
+#ifdef __SSE2__
+  // Bytes up to ' ' (signed: the ones beyond ASCII too) or braces
+  const __m128i after_space = _mm_set1_epi8(' ' + 1);
+  const __m128i start = _mm_set1_epi8(cDegenerate_symbol_start);
+  const __m128i stop = _mm_set1_epi8(cDegenerate_symbol_stop);
+  for (; p + 16 <= end; p += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128i special = _mm_or_si128(
+        _mm_cmplt_epi8(block, after_space),
+        _mm_or_si128(_mm_cmpeq_epi8(block, start),
+                     _mm_cmpeq_epi8(block, stop)));
+    unsigned mask = _mm_movemask_epi8(special);
+    if (mask) {
+      return p + __builtin_ctz(mask);
+    }
+  }
+#endif
+  while (p < end && !is_special(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+ReturnStatus invalid_char(const char c) {
+  std::cerr << "Invalid Input: Not a FASTA format: Invalid character: " << c
+            << std::endl;
+  return ReturnStatus::ERR_INVALID_INPUT;
+}
+} // end anonymous namespace
 
+Parser::Parser(const AlphabetType alphabetType, const std::string &alphabet)
+    : _cAlphabetType(alphabetType), _cAlphabet(alphabet) {
+  _codes.fill(0);
+  for (UINT c = 0; c < _codes.size(); ++c) {
+    char ch = static_cast<char>(c);
+    if (_cAlphabetType == AlphabetType::DNA) {
+      if (is_valid_char_dna(ch)) {
+        _codes[c] = map_char_dna(ch);
+      }
+    } else if (_cAlphabetType == AlphabetType::PROT) {
+      if (is_valid_char_prot(ch)) {
+        _codes[c] = map_char_prot(ch);
+      }
+    } else if (is_valid_char_general(ch)) {
+      _codes[c] = map_char_general(ch);
+    }
+  }
+  // Ambiguity codes (in upper and lower case)
+  _ambiguity_masks.fill(0);
+  const std::vector<std::pair<char, std::string>> *ambiguity_codes = nullptr;
   if (_cAlphabetType == AlphabetType::DNA) {
-    fCheckValidity = &Parser::is_valid_char_dna;
-    fMapChar = &Parser::map_char_dna;
+    ambiguity_codes = &cDNA_ambiguity_codes;
   } else if (_cAlphabetType == AlphabetType::PROT) {
-    fCheckValidity = &Parser::is_valid_char_prot;
-    fMapChar = &Parser::map_char_prot;
+    ambiguity_codes = &cPROT_ambiguity_codes;
   }
-  SEED seed;
-  std::vector<ENCODED_CHAR> symbol;
-  bool is_seed_mode = 1; // 0 for seed, 1 for symbol
+  if (ambiguity_codes != nullptr) {
+    for (const auto &code : *ambiguity_codes) {
+      SYMBOL_MASK mask = 0;
+      for (char letter : code.second) {
+        assert(code_of(letter) < cMask_bits);
+        mask |= SYMBOL_MASK(1) << code_of(letter);
+      }
+      _ambiguity_masks[static_cast<unsigned char>(code.first)] = mask;
+      _ambiguity_masks[static_cast<unsigned char>(std::tolower(code.first))] =
+          mask;
+    }
+  }
+}
+
+ReturnStatus Parser::parse_sequence(std::istream &infile,
+                                    Degenerate_string &dgs) const {
+  // The lines up to the end of this sequence
+  std::string body;
   std::string line;
   while (std::getline(infile, line)) {
     if (line.empty()) {
       break; // end of this sequece
     }
-    for (char c : line) {
-      if (isspace(c)) {
-        // Ignore
-      } else if (c == cDegenerate_symbol_start) {
-        seed.shrink_to_fit();
-        dgs.add_seed(seed);
-        seed.clear();
-        is_seed_mode = false;
-      } else if (c == cDegenerate_symbol_stop) {
-        if (symbol.size() < 2) {
-          std::cerr
-              << "Invalid Input: Degenerate symbol has less than two letters."
-              << std::endl;
-          return ReturnStatus::ERR_INVALID_INPUT;
-        }
-        dgs.add_degenerate_symbol(symbol);
-        symbol.clear();
-        is_seed_mode = true;
-      } else if ((this->*fCheckValidity)(c)) {
-        if (is_seed_mode) { // currently collecting seed
-          seed.push_back((this->*fMapChar)(c));
-        } else { // currently collecting symbol
-          symbol.push_back((this->*fMapChar)(c));
-        }
+    body += line;
+    body += '\n';
+  }
+  return parse_sequence(body.data(), body.data() + body.size(), dgs);
+}
 
-      } else {
-        std::cerr << "Invalid Input: Not a FASTA format: Invalid character: "
-                  << c << std::endl;
+ReturnStatus Parser::parse_sequence(
+    const char *begin, const char *end, Degenerate_string &dgs,
+    const std::vector<Variant_site> *sites) const {
+  std::vector<ENCODED_CHAR> symbol;
+  bool is_seed_mode = true; // false while collecting a symbol
+  dgs.reserve(end - begin);
+  dgs.start_seed();
+  // Sites of variants not yet reached (in the order of their positions)
+  const Variant_site *next_site = nullptr;
+  const Variant_site *sites_end = nullptr;
+  if (sites != nullptr) {
+    next_site = sites->data();
+    sites_end = next_site + sites->size();
+  }
+  // Mask of the variant at the current position (0 if there is none)
+  auto site_mask = [&]() -> SYMBOL_MASK {
+    while (next_site < sites_end && next_site->pos < dgs.get_size()) {
+      ++next_site; // within a symbol already added
+    }
+    if (next_site < sites_end && next_site->pos == dgs.get_size()) {
+      return (next_site++)->mask;
+    }
+    return 0;
+  };
+  const char *p = begin;
+  while (p < end) {
+    if (is_seed_mode) {
+      // Decode the run of letters in place, up to anything else (e.g. an
+      // ambiguity code) or to the next variant
+      const char *stop = find_special(p, end);
+      while (next_site < sites_end && next_site->pos < dgs.get_size()) {
+        ++next_site; // within a symbol already added
+      }
+      if (next_site < sites_end &&
+          next_site->pos - dgs.get_size() < static_cast<UINT>(stop - p)) {
+        stop = p + (next_site->pos - dgs.get_size());
+      }
+      ENCODED_CHAR *letters = dgs.append_letters(stop - p);
+      const char *q = p;
+      for (; q < stop; ++q) {
+        uint8_t code = code_of(*q);
+        if (code == 0) {
+          break;
+        }
+        *letters++ = code;
+      }
+      dgs.drop_letters(stop - q);
+      p = q;
+      if (p == end) {
+        break;
+      }
+    }
+    char c = *p++;
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      // Ignore
+    } else if (c == cDegenerate_symbol_start) {
+      if (!is_seed_mode) {
+        std::cerr << "Invalid Input: Degenerate symbol within a degenerate "
+                     "symbol (no "
+                  << cDegenerate_symbol_stop << " found)." << std::endl;
+        return ReturnStatus::ERR_INVALID_INPUT;
+      }
+      is_seed_mode = false;
+    } else if (c == cDegenerate_symbol_stop) {
+      for (SYMBOL_MASK mask = site_mask(); mask != 0; mask &= mask - 1) {
+        symbol.push_back(__builtin_ctz(mask));
+      }
+      if (symbol.size() < 2) {
+        std::cerr
+            << "Invalid Input: Degenerate symbol has less than two letters."
+            << std::endl;
         return ReturnStatus::ERR_INVALID_INPUT;
       }
+      dgs.add_degenerate_symbol(symbol);
+      symbol.clear();
+      dgs.start_seed();
+      is_seed_mode = true;
+    } else if (code_of(c) != 0 || ambiguity_mask_of(c) != 0) {
+      if (!is_seed_mode) {
+        if (code_of(c) != 0) {
+          symbol.push_back(code_of(c));
+        }
+        for (SYMBOL_MASK mask = ambiguity_mask_of(c); mask != 0;
+             mask &= mask - 1) {
+          symbol.push_back(__builtin_ctz(mask));
+        }
+        continue;
+      }
+      SYMBOL_MASK mask = site_mask();
+      if (mask == 0 && code_of(c) != 0) {
+        *dgs.append_letters(1) = code_of(c);
+      } else { // a degenerate symbol on its own
+        dgs.add_degenerate_symbol(mask | letter_mask(c));
+        dgs.start_seed();
+      }
+    } else {
+      return invalid_char(c);
     }
   } // sequence ends
-  // Adding the last seed
-  seed.shrink_to_fit();
-  dgs.add_seed(seed);
   if (dgs.get_size() == 0) {
     std::cerr << "Invalid Input: Empty Sequence." << std::endl;
     return ReturnStatus::ERR_INVALID_INPUT;
@@ -84,6 +226,10 @@ ReturnStatus Parser::parse_sequence(std::ifstream &infile,
               << cDegenerate_symbol_stop << " found)." << std::endl;
     return ReturnStatus::ERR_INVALID_INPUT;
   }
+  if (next_site < sites_end) {
+    std::cerr << "Warning: " << (sites_end - next_site)
+              << " variant sites beyond the end of the sequence." << std::endl;
+  }
 
   return ReturnStatus::SUCCESS;
 }
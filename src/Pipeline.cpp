@@ -0,0 +1,393 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements class Pipeline
+ */
+#include "../include/Pipeline.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+#include "../include/Lpf_file.hpp"
+#include "../include/Search.hpp"
+
+namespace deglpf {
+
+Pipeline::Pipeline(const Parser &parser, const UINT alphabet_size,
+                   const SearchOptions &search_options,
+                   const PipelineOptions &options,
+                   const Variant_sites *variant_sites)
+    : _parser(parser), _alphabet_size(alphabet_size),
+      _search_options(search_options),
+      _num_workers(std::max<UINT>(options.num_workers, 1)),
+      _group_size(std::max<UINT>(options.group_size, 1)),
+      // A group is handed over only when all its records are read
+      _max_in_flight(std::max(
+          (options.max_in_flight > 0) ? (options.max_in_flight)
+                                      : (2 * _num_workers * _group_size),
+          _group_size)),
+      _print_stats(options.print_stats),
+      _output_format(options.output_format), _variant_sites(variant_sites) {}
+
+ReturnStatus Pipeline::run(std::istream &infile, std::ostream &outfile) {
+  std::string line;
+  // Get the first sequence
+  std::getline(infile, line);
+  if (line.empty()) {
+    std::cerr << "No Input: Empty File: " << std::endl;
+    return ReturnStatus::ERR_INVALID_INPUT;
+  }
+  _in_flight.clear();
+  _pending.clear();
+  _reading_done = false;
+  _stop = false;
+
+  std::thread reader(&Pipeline::read_records, this, std::ref(infile), line);
+  return write_records(reader, outfile);
+}
+
+ReturnStatus Pipeline::run(const char *begin, const char *end,
+                           std::ostream &outfile) {
+  if (begin == end || *begin == '\n') { // the first line is empty
+    std::cerr << "No Input: Empty File: " << std::endl;
+    return ReturnStatus::ERR_INVALID_INPUT;
+  }
+  _in_flight.clear();
+  _pending.clear();
+  _reading_done = false;
+  _stop = false;
+
+  std::thread reader(&Pipeline::read_mapped_records, this, begin, end);
+  return write_records(reader, outfile);
+}
+
+//////////////////////// private ////////////////////////
+ReturnStatus Pipeline::write_records(std::thread &reader,
+                                     std::ostream &outfile) {
+  if (_output_format != OutputFormat::TEXT) { // a binary format
+    outfile.write(cLpf_file_magic, sizeof(cLpf_file_magic));
+  }
+  std::vector<std::thread> workers;
+  for (UINT w = 0; w < _num_workers; ++w) {
+    workers.emplace_back(&Pipeline::process_records, this);
+  }
+
+  /* Write the records in their order */
+  ReturnStatus status = ReturnStatus::SUCCESS;
+  while (true) {
+    std::shared_ptr<Record> record;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _write_cv.wait(lock, [this] {
+        return (!_in_flight.empty() && _in_flight.front()->done) ||
+               (_in_flight.empty() && _reading_done);
+      });
+      if (_in_flight.empty()) {
+        break; // all the records written
+      }
+      record = _in_flight.front();
+      _in_flight.pop_front();
+      if (record->status != ReturnStatus::SUCCESS) {
+        _stop = true; // the records after it are dropped
+      }
+    }
+    _read_cv.notify_one();
+    if (record->status != ReturnStatus::SUCCESS) {
+      if (!record->name.empty()) {
+        std::cerr << "Invalid Input: Invalid sequence: " << record->name
+                  << std::endl;
+      }
+      status = record->status;
+      break;
+    }
+    std::cout << record->stats;
+    outfile << record->result;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _read_cv.notify_all();
+  _work_cv.notify_all();
+  reader.join();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  outfile.flush();
+  if (status == ReturnStatus::SUCCESS) {
+    std::cout << "LPF calculated successfully: " << std::endl;
+  }
+  return status;
+}
+
+void Pipeline::read_records(std::istream &infile, std::string header) {
+  std::vector<std::shared_ptr<Record>> group;
+  std::string line = header;
+  do {
+    if (line.empty()) {
+      continue; // blank lines between the records
+    }
+    if (!wait_to_read()) {
+      break;
+    }
+    if (line[0] != '>') {
+      add_invalid_header();
+      break;
+    }
+    auto record = std::make_shared<Record>();
+    record->name = line.substr(1);
+    // One write; the writer prints from another thread
+    std::cout << ("Processing Sequence: " + record->name + "\n") << std::flush;
+    // The sequence ends at an empty line
+    while (std::getline(infile, line) && !line.empty()) {
+      record->body += line;
+      record->body += '\n';
+    }
+    record->begin = record->body.data();
+    record->end = record->begin + record->body.size();
+    add_in_flight(record);
+    group.push_back(record);
+    if (group.size() == _group_size) {
+      hand_over(group);
+    }
+  } while (std::getline(infile, line)); // sequence ends
+  hand_over(group); // the last one may be smaller
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _reading_done = true;
+  }
+  _work_cv.notify_all();
+  _write_cv.notify_one();
+}
+
+void Pipeline::read_mapped_records(const char *begin, const char *end) {
+  std::vector<std::shared_ptr<Record>> group;
+  // The line at p ends at the next newline (or at the end)
+  auto line_end = [end](const char *p) {
+    const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    return (nl == nullptr) ? (end) : (nl);
+  };
+  auto next_line = [end](const char *eol) {
+    return (eol < end) ? (eol + 1) : (end);
+  };
+  const char *p = begin;
+  while (p < end) {
+    const char *eol = line_end(p);
+    if (eol == p) {
+      ++p; // blank lines between the records
+      continue;
+    }
+    if (!wait_to_read()) {
+      break;
+    }
+    if (*p != '>') {
+      add_invalid_header();
+      break;
+    }
+    auto record = std::make_shared<Record>();
+    record->name.assign(p + 1, eol);
+    // One write; the writer prints from another thread
+    std::cout << ("Processing Sequence: " + record->name + "\n") << std::flush;
+    // The sequence ends at an empty line (or at the end)
+    record->begin = record->end = next_line(eol);
+    for (p = record->begin; p < end; p = next_line(eol)) {
+      eol = line_end(p);
+      if (eol == p) {
+        break;
+      }
+      record->end = eol;
+    }
+    if (p < end) {
+      ++p; // the empty line
+    }
+    add_in_flight(record);
+    group.push_back(record);
+    if (group.size() == _group_size) {
+      hand_over(group);
+    }
+  }
+  hand_over(group); // the last one may be smaller
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _reading_done = true;
+  }
+  _work_cv.notify_all();
+  _write_cv.notify_one();
+}
+
+bool Pipeline::wait_to_read() {
+  // Wait for a record to be written
+  std::unique_lock<std::mutex> lock(_mutex);
+  _read_cv.wait(lock, [this] {
+    return _stop || _in_flight.size() < _max_in_flight;
+  });
+  return !_stop;
+}
+
+void Pipeline::add_invalid_header() {
+  std::cerr << "Invalid Input: Not a FASTA format: Expected '>' at line number"
+            << std::endl;
+  auto record = std::make_shared<Record>();
+  record->status = ReturnStatus::ERR_INVALID_INPUT;
+  record->done = true;
+  add_in_flight(record);
+}
+
+void Pipeline::add_in_flight(const std::shared_ptr<Record> &record) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _in_flight.push_back(record);
+  }
+  if (record->done) {
+    _write_cv.notify_one();
+  }
+}
+
+void Pipeline::hand_over(std::vector<std::shared_ptr<Record>> &group) {
+  if (group.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending.push_back(std::move(group));
+  }
+  group.clear();
+  _work_cv.notify_one();
+}
+
+void Pipeline::process_records() {
+  while (true) {
+    std::vector<std::shared_ptr<Record>> group;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _work_cv.wait(lock, [this] {
+        return _stop || !_pending.empty() || _reading_done;
+      });
+      if (_stop || _pending.empty()) {
+        break; // nothing more to process
+      }
+      group = std::move(_pending.front());
+      _pending.pop_front();
+    }
+    process_group(group);
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (auto &record : group) {
+        record->done = true;
+      }
+    }
+    _write_cv.notify_one();
+  }
+}
+
+void Pipeline::process_group(
+    const std::vector<std::shared_ptr<Record>> &group) const {
+  /* Encode the sequences */
+  std::vector<std::unique_ptr<Degenerate_string>> strings;
+  std::vector<const Degenerate_string *> valid_strings;
+  std::vector<Record *> valid_records;
+  for (auto &record : group) {
+    strings.emplace_back(new Degenerate_string(_alphabet_size));
+    const std::vector<Variant_site> *sites =
+        (_variant_sites == nullptr)
+            ? (nullptr)
+            : (_variant_sites->get_sites_of_record(record->name));
+    record->status = _parser.parse_sequence(record->begin, record->end,
+                                            *strings.back(), sites);
+    std::string().swap(record->body); // no longer needed
+    if (record->status == ReturnStatus::SUCCESS) {
+      valid_strings.push_back(strings.back().get());
+      valid_records.push_back(record.get());
+    }
+  }
+  if (valid_records.empty()) {
+    return;
+  }
+  if (_group_size == 1) {
+    for (UINT s = 0; s < valid_records.size(); ++s) {
+      calculate_record(*valid_records[s], *valid_strings[s], nullptr, 0);
+    }
+    return;
+  }
+  /* Calculate the LPF arrays with one index of all the sequences */
+  Shared_index shared_index(valid_strings, _search_options);
+  for (UINT s = 0; s < valid_records.size(); ++s) {
+    calculate_record(*valid_records[s], *valid_strings[s], &shared_index, s);
+  }
+}
+
+void Pipeline::calculate_record(Record &record, const Degenerate_string &dgs,
+                                const Shared_index *shared_index,
+                                const UINT str) const {
+  /* Calculate the LPF array and LPF-loc arrays for the sequence */
+  auto seq_size = dgs.get_size();
+  std::vector<UINT> lpf;
+  Irreducible_lpf irreducible_lpf; // for the output of this format only
+  std::unique_ptr<Search> search(
+      (shared_index == nullptr)
+          ? (new Search(dgs, _search_options))
+          : (new Search(dgs, *shared_index, str, _search_options)));
+
+  // Wall-clock time (CPU time would add up the time of all the threads)
+  auto startTime = std::chrono::steady_clock::now();
+  if (_output_format == OutputFormat::IRREDUCIBLE) {
+    search->calculate_lpf(irreducible_lpf);
+  } else {
+    lpf.resize(seq_size, 0);
+    search->calculate_lpf(lpf);
+  }
+  auto stopTime = std::chrono::steady_clock::now();
+  double exec_time =
+      std::chrono::duration<double>(stopTime - startTime).count();
+  if (_print_stats) {
+    auto stats = search->get_chain_stats();
+    std::ostringstream stats_stream;
+    stats_stream << "Chains of degenerate matches (" << record.name
+                 << "): " << stats.num_chains << " (cells: " << stats.num_cells
+                 << ", longest: " << stats.longest << ")" << std::endl;
+    record.stats = stats_stream.str();
+  }
+#ifdef DEBUG
+  // PRINTING FOR DEBUGGING
+  std::cout << "LPF ARRAY: \n";
+  if (_output_format == OutputFormat::IRREDUCIBLE) {
+    irreducible_lpf.get_lpf(lpf);
+  }
+  for (UINT c : lpf) {
+    std::cout << c << " ";
+  }
+  std::cout << "\n";
+#endif
+  /* Print result */
+  if (_output_format == OutputFormat::TEXT) {
+    record.result.clear();
+    write_text_record(record.result, record.name, exec_time,
+                      dgs.get_numberof_seeds() - 1, lpf,
+                      _search_options.num_threads);
+    return;
+  }
+  std::ostringstream outfile;
+  if (_output_format == OutputFormat::BINARY) {
+    write_binary_record(outfile, record.name, exec_time,
+                        dgs.get_numberof_seeds() - 1, lpf);
+  } else {
+    write_irreducible_record(outfile, record.name, exec_time,
+                             dgs.get_numberof_seeds() - 1, irreducible_lpf);
+  }
+  record.result = outfile.str();
+}
+
+} // end namespace
@@ -0,0 +1,86 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements class Prefix_table
+ */
+#include "../include/Prefix_table.hpp"
+
+#include <new>
+#include <sys/mman.h>
+
+namespace deglpf {
+
+Prefix_table::Prefix_table(const UINT num_rows, const UINT num_cols,
+                           const UINT max_value, const TableLayout layout)
+    : _num_rows(num_rows), _num_cols(num_cols), _layout(layout) {
+  // Bits needed for max_value + 1, rounded up to a divisor of 64
+  uint8_t width = 8;
+  while (width < 64 &&
+         (static_cast<uint64_t>(max_value) + 1) >> width != 0) {
+    width *= 2;
+  }
+  _width = width;
+  _num_bytes =
+      (static_cast<uint64_t>(num_rows) * num_cols * width + 63) / 64 * 8;
+  if (_num_bytes == 0) {
+    return;
+  }
+  // The pages are not written here: they read as zero (unfilled cells)
+  void *words = mmap(nullptr, _num_bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (words == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  _words = static_cast<uint64_t *>(words);
+}
+
+Prefix_table::~Prefix_table() {
+  if (_words != nullptr) {
+    munmap(_words, _num_bytes);
+  }
+}
+
+INT Prefix_table::get(const UINT row, const UINT col) const {
+  uint64_t bit = cell_index(row, col) * _width;
+  uint64_t word = __atomic_load_n(_words + (bit >> 6), __ATOMIC_RELAXED);
+  uint64_t cell = (word >> (bit & 63)) & sdsl::bits::lo_set[_width];
+  return static_cast<INT>(cell) - 1;
+}
+
+void Prefix_table::set(const UINT row, const UINT col, const INT value) {
+  assert(get(row, col) == -1 || get(row, col) == value);
+  uint64_t bit = cell_index(row, col) * _width;
+  // The cell is 0 (unfilled) or already holds the value: OR-ing leaves the
+  // neighbouring cells of the word intact
+  uint64_t cell = static_cast<uint64_t>(value + 1) << (bit & 63);
+  __atomic_fetch_or(_words + (bit >> 6), cell, __ATOMIC_RELAXED);
+}
+
+void Prefix_table::prefetch(const UINT row, const UINT col) const {
+  __builtin_prefetch(_words + ((cell_index(row, col) * _width) >> 6));
+}
+
+UINT Prefix_table::get_width() const { return _width; }
+
+//////////////////////// private ////////////////////////
+
+uint64_t Prefix_table::cell_index(const UINT row, const UINT col) const {
+  if (_layout == TableLayout::POSITION_MAJOR) {
+    return static_cast<uint64_t>(col) * _num_rows + row;
+  }
+  return static_cast<uint64_t>(row) * _num_cols + col;
+}
+
+} // end namespace
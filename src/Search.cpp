@@ -17,35 +17,184 @@
  */
 #include "../include/Search.hpp"
 
+#include <omp.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace deglpf {
 
-Search::Search(const Degenerate_string &dgs)
+namespace {
+// Number of equal symbols (at most len) of the sequences starting at s1 and s2
+UINT direct_lce(const ENCODED_CHAR *s1, const ENCODED_CHAR *s2,
+                const UINT len) {
+  UINT l = 0;
+#ifdef __SSE2__
+  for (; l + 4 <= len; l += 4) {
+    __m128i eq = _mm_cmpeq_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(s1 + l)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(s2 + l)));
+    unsigned mismatch = ~_mm_movemask_ps(_mm_castsi128_ps(eq)) & 0xF;
+    if (mismatch) {
+      return l + __builtin_ctz(mismatch);
+    }
+  }
+#endif
+  while (l < len && s1[l] == s2[l]) {
+    ++l;
+  }
+  return l;
+}
+
+// Number of equal symbols (at most len) of the sequences ending at e1 and e2
+// read backwards
+UINT direct_lce_backward(const ENCODED_CHAR *e1, const ENCODED_CHAR *e2,
+                         const UINT len) {
+  UINT l = 0;
+#ifdef __SSE2__
+  for (; l + 4 <= len; l += 4) {
+    __m128i eq = _mm_cmpeq_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(e1 - l - 3)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(e2 - l - 3)));
+    unsigned mismatch = ~_mm_movemask_ps(_mm_castsi128_ps(eq)) & 0xF;
+    if (mismatch) { // the highest lane is the first one read
+      return l + __builtin_clz(mismatch) - 28;
+    }
+  }
+#endif
+  while (l < len && *(e1 - l) == *(e2 - l)) {
+    ++l;
+  }
+  return l;
+}
+
+// Z-array of the given sequence: z[i] is the lcp of the sequence and its
+// suffix at i (z[0] is the length of the sequence)
+void z_array(const std::vector<ENCODED_CHAR> &seq, std::vector<UINT> &z) {
+  UINT n = seq.size();
+  z.assign(n, 0);
+  if (n == 0) {
+    return;
+  }
+  z[0] = n;
+  UINT left = 0;
+  UINT right = 0; // [left, right) is the rightmost match found
+  for (UINT i = 1; i < n; ++i) {
+    UINT l = 0;
+    if (i < right) {
+      l = std::min(right - i, z[i - left]);
+    }
+    while (i + l < n && seq[l] == seq[i + l]) {
+      ++l;
+    }
+    z[i] = l;
+    if (i + l > right) {
+      left = i;
+      right = i + l;
+    }
+  }
+}
+
+// Sets target to value if it is larger; safe to be called concurrently
+void atomic_max(UINT &target, const UINT value) {
+  UINT current = __atomic_load_n(&target, __ATOMIC_RELAXED);
+  while (current < value &&
+         !__atomic_compare_exchange_n(&target, &current, value, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+// LPF-Simple: lpf of each position from the rank of its suffix and the lcp
+// array (its entry past the last rank being 0); the lcp array is overwritten
+void lpf_simple(const std::vector<UINT> &rank_of, std::vector<UINT> &lcp,
+                std::vector<UINT> &lpf) {
+  INT num_ranks = static_cast<INT>(lcp.size()) - 1;
+  std::vector<INT> prev(num_ranks, 0);
+  std::vector<INT> next(num_ranks, 0);
+  for (INT r = 0; r < num_ranks; ++r) {
+    prev[r] = r - 1;
+    next[r] = r + 1;
+  }
+  // Suffixes are removed from the last one; the remaining ones precede it
+  for (INT i = static_cast<INT>(rank_of.size()) - 1; i >= 0; --i) {
+    INT r = rank_of[i];
+    lpf[i] = std::max(lcp[r], lcp[next[r]]);
+    lcp[next[r]] = std::min(lcp[r], lcp[next[r]]);
+    if (prev[r] >= 0) {
+      next[prev[r]] = next[r];
+    }
+    if (next[r] < num_ranks) {
+      prev[next[r]] = prev[r];
+    }
+  }
+}
+} // end anonymous namespace
+
+Search::Search(const Degenerate_string &dgs, const SearchOptions &options)
+    : Search(dgs, nullptr, 0, options) {}
+
+Search::Search(const Degenerate_string &dgs, const Shared_index &shared_index,
+               const UINT str, const SearchOptions &options)
+    : Search(dgs, &shared_index, str, options) {}
+
+Search::Search(const Degenerate_string &dgs, const Shared_index *shared_index,
+               const UINT str, const SearchOptions &options)
     : _dgs(dgs),
-      _letter_ind_in_rev(dgs.get_alphabet_size() + 1, std::list<UINT>{}),
       _degenerate_indices(dgs.get_degenerate_indices()),
+      _seed_offsets(dgs.get_seed_offsets()), _symbols(dgs.get_symbols()),
       _seq_size(dgs.get_size()), _k(dgs.get_numberof_seeds() - 1),
-      _longest_degenerate_prefix(dgs.get_numberof_seeds() - 1,
-                                 std::vector<INT>(dgs.get_size(), -1)),
-      _solid_lpf(_seq_size, 0) {}
+      _options(options), _shared_index(shared_index), _shared_str(str),
+      _letter_offsets(dgs.get_alphabet_size() + 2, 0),
+      _solid_lpf(_seq_size, 0),
+      _longest_degenerate_prefix(dgs.get_numberof_seeds() - 1, dgs.get_size(),
+                                 dgs.get_size(), options.table_layout),
+      _chains(options.num_threads), _chain_stats(options.num_threads) {}
 
 ReturnStatus Search::calculate_lpf(std::vector<UINT> &lpf) {
+  return calculate(lpf, nullptr);
+}
+
+ReturnStatus Search::calculate_lpf(Irreducible_lpf &lpf) {
+  // The array is calculated in full (its cells are updated in any order);
+  // only the compressed one is kept
+  std::vector<UINT> full_lpf(_seq_size, 0);
+  std::vector<UINT> irreducible;
+  ReturnStatus status = calculate(full_lpf, &irreducible);
+  lpf = Irreducible_lpf(full_lpf, irreducible);
+  return status;
+}
+
+ReturnStatus Search::calculate(std::vector<UINT> &lpf,
+                               std::vector<UINT> *irreducible) {
   // std::cout << "Calculation started. " << std::endl;
   /* Preprocess */
   preprocess(lpf);
 
+  /* Type 2 tables (one per block; each is built independently) */
+  std::vector<std::vector<UINT>> type2_results(_k);
+#pragma omp parallel for schedule(dynamic) num_threads(_options.num_threads)
+  for (INT block = 0; block < _k; ++block) {
+    fill_type2_table(block, type2_results[block]);
+  }
+
   /* Calculate */
-  UINT block = 0;
-  bool type2 = false;
-  std::vector<UINT> type2_result{};
-  for (auto i = 0; i < _seq_size; ++i) {
-    if (block < _k && i == _degenerate_indices[block]) { // at degenerate symbol
+  // Work per position grows with its block; hence dynamic scheduling
+#pragma omp parallel num_threads(_options.num_threads)
+  {
+  LCP_batch batch; // of this thread
+#pragma omp for schedule(dynamic, cPosition_chunk_size)
+  for (INT i = 0; i < _seq_size; ++i) {
+    // Number of degenerate symbols at or before this position
+    UINT block = std::upper_bound(_degenerate_indices.begin(),
+                                  _degenerate_indices.end(), i) -
+                 _degenerate_indices.begin();
+    if (block > 0 && i == _degenerate_indices[block - 1]) {
+// at degenerate symbol; its lpf has been found while preprocessing
 #ifdef DEBUG
       // PRINTING FOR DEBUGGING
-      std::cout << "At Symbol: " << block << std::endl;
+      std::cout << "At Symbol: " << block - 1 << std::endl;
 #endif
-      ++block;
-      type2 = false;
-      type2_result.clear();
     } else { // in seed
              // Note that we are here as seed is not empty
       auto solid_l = _solid_lpf[i];
@@ -55,141 +204,171 @@ ReturnStatus Search::calculate_lpf(std::vector<UINT> &lpf) {
       // PRINTING FOR DEBUGGING
       std::cout << "Type 1 at : i L: " << i << " " << solid_l << std::endl;
 #endif
-      for (auto j = 0; j < block; ++j) { // for each previous block (or seed)
-        auto stop_pos = _degenerate_indices[j];
-        // Check L-region in jth block (seed)
-        auto first_pos = (j == 0) ? (0) : (_degenerate_indices[j - 1] + 1);
-        UINT temp=  stop_pos - solid_l;
-        if (static_cast<INT>(stop_pos) - static_cast<INT>(solid_l) < 0) {
-          temp = 0;
-        }
-        INT start_pos = std::max(temp, first_pos);
-#ifdef DEBUG
-        // PRINTING FOR DEBUGGING
-        std::cout << "Checking in block : block start_pos stop_pos: " << j << " " << start_pos
-                  << " " << stop_pos << std::endl;
-#endif
-        for (auto pos = start_pos; pos < stop_pos; ++pos) {
-          auto lcp = getLCP(pos, i, _fwd_search_ds);
-          auto match_upto_pos = i + lcp;
-          if ((pos + lcp) == stop_pos &&
-              (match_upto_pos !=
-               _seq_size)) { // Prefix of L is suffix of this seed
-            UINT possible_lpf =
-                lcp + _longest_degenerate_prefix[j][match_upto_pos];
-#ifdef DEBUG
-            // PRINTING FOR DEBUGGING
-            std::cout << "Candiadte : pos possible_lpf: " << pos << " "
-                      << possible_lpf << std::endl;
-#endif
-            lpf[i] = std::max(lpf[i], possible_lpf);
-          }
-        } // Checked L-region
-        // Check jth symbol
+      // Check each previous symbol (the cells of a position are contiguous
+      // in the position-major layout)
+      for (auto j = 0; j < block; ++j) {
         lpf[i] = std::max(lpf[i],
-                          static_cast<UINT>(_longest_degenerate_prefix[j][i]));
-      } // Checked each block(seed)
-
-      /* Type 2 Search, if needed */
-      if (block < _k && (i + solid_l == _degenerate_indices[block])) {
-#ifdef DEBUG
-        // PRINTING FOR DEBUGGING
-        std::cout << "Type 2 at : i  " << i << std::endl;
-#endif
-        // Note that we will not be here for i=0 (as solid_l will be 0)
-        if (!type2) { // enter into type 2 mode for the first time
-          std::vector<UINT> type2_local(solid_l + 1, 0);
-
-          ENCODED_CHAR c = _dgs.get_seed_lastletter(block);
-          auto following_symb_pos = _degenerate_indices[block];
-          auto rev_i = _seq_size - i - 1;
-          auto rev_last_pos = _seq_size - following_symb_pos;
-          auto rev_stop_pos =
-              (block == 0) ? (_seq_size)
-                           : (_seq_size - 1 - _degenerate_indices[block - 1]);
-          // for each occurrence (succeeding) of letter in reverse, find
-          // potential longer lpf
-          for (auto p : _letter_ind_in_rev[c]) {
-            if (p > rev_last_pos) {
-              auto rev_lcp = 1;
-              if ((rev_last_pos + 1) < rev_stop_pos &&
-                  (p + 1 < _seq_size)) { // Take rev-lpf if  there are solid
-                // letters preceeding it in the seed
-                rev_lcp += getLCP(p + 1, rev_last_pos + 1, _rev_search_ds);
-              }
-              // find tail of the match
-              auto tail_match = 0;
-              auto reverse_next_p = _seq_size - p;
-              if (reverse_next_p < _seq_size) {
-                tail_match = _longest_degenerate_prefix[block][reverse_next_p];
-              }
-              UINT potential_lpf = rev_lcp + tail_match;
-
-              // update the lpf-value of the corresponding length
-              type2_local[rev_lcp] =
-                  std::max(type2_local[rev_lcp], potential_lpf);
-            } else {
-              break;
-            }
+                          static_cast<UINT>(get_longest_degenerate_prefix(j, i)));
+      }
+      // (With LRegionSearch::BORDERS, the candidates are found afterwards)
+      if (_options.l_region_search == LRegionSearch::SCAN) {
+        // The LCP queries of the L-regions are answered in batches
+        for (auto j = 0; j < block; ++j) { // for each previous block (or seed)
+          auto stop_pos = _degenerate_indices[j];
+          // Check L-region in jth block (seed)
+          auto first_pos = _seed_offsets[j];
+          UINT temp=  stop_pos - solid_l;
+          if (static_cast<INT>(stop_pos) - static_cast<INT>(solid_l) < 0) {
+            temp = 0;
           }
-          type2 = true;
-          type2_result = std::move(type2_local);
+          INT start_pos = std::max(temp, first_pos);
 #ifdef DEBUG
           // PRINTING FOR DEBUGGING
-          std::cout << "L-Table : " << std::endl;
-          for (auto c : type2_result) {
-            std::cout << c << " ";
-          }
-          std::cout << std::endl;
+          std::cout << "Checking in block : block start_pos stop_pos: " << j << " " << start_pos
+                    << " " << stop_pos << std::endl;
 #endif
-        }
-        // Use the stored result to find answer
-        UINT potential_type2_lpf = (lpf[i - 1] == 0) ? (0) : (lpf[i - 1] - 1);
-        potential_type2_lpf =
-            std::max(type2_result[solid_l], potential_type2_lpf);
+          for (auto pos = start_pos; pos < stop_pos; ++pos) {
+            batch.add(pos, i, j);
+            if (batch.size() == cLCP_batch_size) {
+              lpf[i] = std::max(lpf[i], check_l_regions(i, batch));
+            }
+          } // Checked L-region
+        } // Checked each block(seed)
+        lpf[i] = std::max(lpf[i], check_l_regions(i, batch));
+      }
+
+      /* Type 2 Search, if needed (the stored result of this block) */
+      if (block < _k && (i + solid_l == _degenerate_indices[block])) {
 #ifdef DEBUG
         // PRINTING FOR DEBUGGING
-        std::cout << "Candiadte : Type2 possible_lpf: " << potential_type2_lpf
-                  << std::endl;
+        std::cout << "Type 2 at : i  " << i << std::endl;
 #endif
-        lpf[i] = std::max(lpf[i], potential_type2_lpf);
+        lpf[i] = std::max(lpf[i], type2_results[block][solid_l]);
       }
     }
 #ifdef DEBUG
     // PRINTING FOR DEBUGGING
-    std::cout << "Final ans: " << lpf[i] << std::endl;
+    std::cout << "Type 1 ans: " << lpf[i] << std::endl;
 #endif
   } // Filled each position
+  }
+
+  /* Type 1 Search in the L-regions, one block (seed) at a time */
+  if (_options.l_region_search == LRegionSearch::BORDERS) {
+#pragma omp parallel for schedule(dynamic) num_threads(_options.num_threads)
+    for (INT j = 0; j < _k; ++j) {
+      find_l_region_candidates(j, lpf);
+    }
+  }
+
+  /* Type 2 Search: a match may continue the one found at the previous
+   * position; so this pass runs in order of the positions (and each one is
+   * final when it is passed) */
+  UINT block = 0;
+  for (auto i = 0; i < _seq_size; ++i) {
+    if (block < _k && i == _degenerate_indices[block]) { // at degenerate symbol
+      ++block;
+    } else if (block < _k &&
+               (i + _solid_lpf[i] == _degenerate_indices[block])) {
+      // Note that we will not be here for i=0 (as solid_l will be 0)
+      UINT potential_type2_lpf = (lpf[i - 1] == 0) ? (0) : (lpf[i - 1] - 1);
+#ifdef DEBUG
+      // PRINTING FOR DEBUGGING
+      std::cout << "Candiadte : Type2 possible_lpf: " << i << " "
+                << potential_type2_lpf << std::endl;
+#endif
+      lpf[i] = std::max(lpf[i], potential_type2_lpf);
+    }
+    if (irreducible != nullptr &&
+        (i == 0 || Irreducible_lpf::is_irreducible(lpf, i))) {
+      irreducible->push_back(i);
+    }
+  }
 
   // std::cout << "Search completed. " << std::endl;
   return ReturnStatus::SUCCESS;
 }
 
+UINT Search::check_l_regions(const UINT i, Search::LCP_batch &batch) {
+  UINT result = 0;
+  getLCPs(batch, _fwd_search_ds);
+  for (UINT q = 0; q < batch.size(); ++q) {
+    auto j = batch.tag[q];
+    auto pos = batch.suff1[q];
+    auto lcp = batch.lcp[q];
+    auto stop_pos = _degenerate_indices[j];
+    auto match_upto_pos = i + lcp;
+    if ((pos + lcp) == stop_pos &&
+        (match_upto_pos != _seq_size)) { // Prefix of L is suffix of this seed
+      UINT possible_lpf = lcp + get_longest_degenerate_prefix(j, match_upto_pos);
+#ifdef DEBUG
+      // PRINTING FOR DEBUGGING
+      std::cout << "Candiadte : pos possible_lpf: " << pos << " "
+                << possible_lpf << std::endl;
+#endif
+      result = std::max(result, possible_lpf);
+    }
+  }
+  batch.clear();
+  return result;
+}
+
+void Search::find_l_region_candidates(const UINT j, std::vector<UINT> &lpf) {
+  auto stop_pos = _degenerate_indices[j];
+  auto first_pos = _seed_offsets[j];
+  UINT m = stop_pos - first_pos; // the seed, reversed, is the pattern
+  if (m == 0) {
+    return;
+  }
+  // pattern[t] is _symbols[stop_pos - 1 - t]; border[q] is the longest proper
+  // border of its prefix of length q
+  const ENCODED_CHAR *pattern_end = &_symbols[stop_pos - 1];
+  std::vector<UINT> border(m + 1, 0);
+  for (UINT q = 1, b = 0; q < m; ++q) {
+    while (b > 0 && *(pattern_end - q) != *(pattern_end - b)) {
+      b = border[b];
+    }
+    if (*(pattern_end - q) == *(pattern_end - b)) {
+      ++b;
+    }
+    border[q + 1] = b;
+  }
+  // KMP over the reversed sequence (down to the following symbol): after
+  // reading position i, a matched prefix of length len means the suffix of
+  // the seed of length len is a prefix of the suffix at i
+  UINT q = 0;
+  for (INT i = static_cast<INT>(_seq_size) - 1; i > stop_pos; --i) {
+    auto c = _symbols[i];
+    while (q > 0 && (q == m || *(pattern_end - q) != c)) {
+      q = border[q];
+    }
+    if (*(pattern_end - q) == c) {
+      ++q;
+    }
+    // Each border is a candidate (none for a degenerate symbol)
+    for (UINT len = q; len > 0; len = border[len]) {
+      auto match_upto_pos = i + len;
+      if (match_upto_pos != _seq_size) {
+        UINT possible_lpf =
+            len + get_longest_degenerate_prefix(j, match_upto_pos);
+#ifdef DEBUG
+        // PRINTING FOR DEBUGGING
+        std::cout << "Candiadte : pos possible_lpf: " << stop_pos - len << " "
+                  << possible_lpf << std::endl;
+#endif
+        atomic_max(lpf[i], possible_lpf);
+      }
+    }
+  }
+}
+
 bool Search::naive_test(std::vector<UINT> &lpf) const {
   std::cout << "NAIVE TESTING: ";
   bool result = true;
-  UINT block_i = 0;
-  UINT base_i = 0;
   for (auto i = 0; i < _seq_size; ++i) {
-    INDEX index1{true, block_i, i - base_i}; // Assuming in seed
-    if (block_i < _k &&
-        i == _degenerate_indices[block_i]) { // at degenerate symbol
-      index1 = INDEX{false, block_i, 0};     // Index of the seed position
-      ++block_i;
-      base_i = i + 1;
-    }
     UINT longest_match = 0;
-    UINT block_j = 0;
-    UINT base_j = 0;
     for (auto j = 0; j < i; ++j) {
-      INDEX index2{true, block_j, j - base_j}; // Index of the seed position
-      if (block_j < _k &&
-          j == _degenerate_indices[block_j]) { // at degenerate symbol
-        index2 = INDEX{false, block_j, 0};     // Index of the symbol
-        ++block_j;
-        base_j = j + 1;
-      }
-      auto l = find_longest_degenerate_match(index1, index2);
+      auto l = find_longest_degenerate_match(i, j);
       longest_match = std::max(longest_match, l);
     }
     if (lpf[i] != longest_match) {
@@ -217,46 +396,40 @@ ReturnStatus Search::preprocess(std::vector<UINT> &lpf) {
   find_solid_lpf();
 
   /* Fill the table of the longest k-lcp at each symbol and each position */
-  for (UINT symb = 0; symb < _k; ++symb) {
-    auto symb_pos = _degenerate_indices[symb];
-    INDEX index1{false, symb, 0}; // Index of the symbol
-    _longest_degenerate_prefix[symb][symb_pos] =
-        0; // The lcp of a symbol with itself is set to 0
-    UINT block = 0;
-    for (auto i = 0; i < _seq_size; ++i) {
-      bool is_deg = false;
-      if (block < _k &&
-          i == _degenerate_indices[block]) { // at degenerate symbol
-        ++block;
-        is_deg = true;
+  // (In lazy mode, a cell is filled when it is read for the first time)
+  if (_options.fill_type == FillType::DIAGONALS) {
+    fill_table_by_diagonals();
+  } else if (_options.fill_type == FillType::ROWS) {
+    fill_table_by_rows();
+  }
+
+  /* Find the lpf for each symbol from its row */
+  // A tile of symbols is read one position at a time; so the reads are
+  // sequential in either layout of the table
+#pragma omp parallel for schedule(dynamic) num_threads(_options.num_threads)
+  for (INT first_symb = 0; first_symb < _k; first_symb += cTable_tile_size) {
+    UINT last_symb = std::min<INT>(first_symb + cTable_tile_size, _k) - 1;
+    UINT symb_begin = first_symb; // first symbol of the tile after position
+    for (auto i = 0; i < _degenerate_indices[last_symb]; ++i) {
+      while (_degenerate_indices[symb_begin] <= i) {
+        ++symb_begin;
       }
-      if (_longest_degenerate_prefix[symb][i] ==
-          -1) { // The cell is uninitalised
-        INDEX index2{};
-        if (is_deg) {                          // at degenerate symbol
-          index2 = INDEX{false, block - 1, 0}; // Index of the symbol
-          fill_longest_degenerate_match(index1, index2);
-        } else { // in seed
-          auto base = (block == 0) ? (0) : (_degenerate_indices[block - 1] + 1);
-          index2 = INDEX{true, block, i - base}; // Index of the symbol
+      for (auto symb = symb_begin; symb <= last_symb; ++symb) {
+        auto symb_pos = _degenerate_indices[symb];
+        auto k_lcp = get_longest_degenerate_prefix(symb, i);
+        if (k_lcp >
+            lpf[symb_pos]) { // It influences the final LPF for this symbol
+          lpf[symb_pos] = k_lcp;
         }
-        fill_longest_degenerate_match(index1, index2);
-      } // This cell filled
-
-      auto k_lcp = _longest_degenerate_prefix[symb][i];
-      if (i < symb_pos &&
-          k_lcp >
-              lpf[symb_pos]) { // It influences the final LPF for this symbol
-        lpf[symb_pos] = k_lcp;
       }
-    } // each position done
-  }   // each symbol done
+    }
+  }
 #ifdef DEBUG
   // PRINTING FOR DEBUGGING
   for (int j = 0; j < _k; ++j) {
     std::cout << "TABLE: " << j << std::endl;
     for (auto i = 0; i < _seq_size; ++i) {
-      std::cout << _longest_degenerate_prefix[j][i] << " ";
+      std::cout << _longest_degenerate_prefix.get(j, i) << " ";
     }
     std::cout << std::endl;
   }
@@ -264,284 +437,580 @@ ReturnStatus Search::preprocess(std::vector<UINT> &lpf) {
   return ReturnStatus::SUCCESS;
 }
 
-// Assumes index_dg is always for a degenerate symbol
-void Search::fill_longest_degenerate_match(const INDEX &index_dg,
-                                           const INDEX &index2) {
-  // Map indices into sequence position
-  auto symb_ind = index_dg.index;
-  auto symb_pos = _degenerate_indices[symb_ind];
-  UINT pos2 = 0;
-  UINT pos2_next_symb_ind = index2.index;
-  if (index2.is_seed) { // solid position
-    auto block = index2.index;
-    auto base = (block == 0) ? (0) : (_degenerate_indices[block - 1] + 1);
-    pos2 = base + index2.inseed_index;
-  } else { // degenerate symbol
-    pos2 = _degenerate_indices[index2.index];
-    ++pos2_next_symb_ind;
-  }
-  /* Find match */
-  INT longest_match = 0;
-  // As at least one symbol is degenerate, ask for approx match at this position
-  if (_dgs.is_match(index_dg, index2)) { // these positions match; extend match
-    longest_match = 1;                   // match is at least 1
-    // If any of the positions exceeds the size, lcp will be returned as 0
-    auto lcp = getLCP(symb_pos + 1, pos2 + 1, _fwd_search_ds);
-    longest_match += lcp;
-    UINT new_pos1 = symb_pos + longest_match;
-    UINT new_pos2 = pos2 + longest_match;
-    UINT next_stop_pos1 =
-        (symb_ind < _k - 1) ? (_degenerate_indices[symb_ind + 1]) : (_seq_size);
-    UINT next_stop_pos2 = (pos2_next_symb_ind < _k)
-                              ? (_degenerate_indices[pos2_next_symb_ind])
-                              : (_seq_size);
-    // any new position goes outside string or both are in seed, we are done
-    // otherwise, add the result in the cell of the new positions.
-    bool new_pos1_deg = (new_pos1 == next_stop_pos1);
-    bool new_pos2_deg = (new_pos2 == next_stop_pos2);
-    if ((new_pos1 < _seq_size) && (new_pos2 < _seq_size) &&
-        (new_pos1_deg || new_pos2_deg)) {
-      UINT new_symb_ind =
-          (new_pos1_deg) ? (symb_ind + 1) : (pos2_next_symb_ind);
-      UINT pos = (new_pos1_deg) ? (new_pos2) : (new_pos1);
-      if (_longest_degenerate_prefix[new_symb_ind][pos] ==
-          -1) {                                   // check the cell
-        INDEX new_index1{false, new_symb_ind, 0}; // Index of the symbol
-        INDEX new_index2;
-        if (new_pos1_deg) {   // Index1 created from pos1
-          if (new_pos2_deg) { // Index2 is degenerate
-            new_index2 = INDEX{false, pos2_next_symb_ind, 0};
-          } else { // Index2 is in seeed
-            auto base = (pos2_next_symb_ind == 0)
-                            ? (0)
-                            : (_degenerate_indices[pos2_next_symb_ind - 1] + 1);
-            new_index2 = INDEX{true, pos2_next_symb_ind, new_pos2 - base};
-          }
-        } else {              // Index1 created from pos2
-          if (new_pos1_deg) { // Index2 is degenerate
-            new_index2 = INDEX{false, symb_ind + 1, 0};
-          } else { // Index2 is in seeed
-            auto base = (_degenerate_indices[symb_ind] + 1);
-            new_index2 = INDEX{true, symb_ind + 1, new_pos1 - base};
+void Search::fill_table_by_rows() {
+  for (UINT symb = 0; symb < _k; ++symb) {
+    _longest_degenerate_prefix.set(
+        symb, _degenerate_indices[symb],
+        0); // The lcp of a symbol with itself is set to 0
+  }
+  // Cells are visited in the order they are laid out
+  LCP_batch batch;
+  if (_options.table_layout == TableLayout::POSITION_MAJOR) {
+    for (UINT i = 0; i < _seq_size; ++i) {
+      for (UINT symb = 0; symb < _k; ++symb) {
+        fill_cell(symb, i, batch);
+      }
+    }
+  } else {
+    for (UINT symb = 0; symb < _k; ++symb) {
+      for (UINT i = 0; i < _seq_size; ++i) {
+        fill_cell(symb, i, batch);
+      }
+    }
+  }
+  fill_batched_cells(batch);
+}
+
+void Search::fill_cell(const UINT symb, const UINT pos,
+                       Search::LCP_batch &batch) {
+  if (_longest_degenerate_prefix.get(symb, pos) ==
+      -1) {                         // The cell is uninitalised
+    auto symb_pos = _degenerate_indices[symb];
+    if (!_dgs.is_match(symb_pos, pos)) {
+      fill_longest_degenerate_match(symb, pos); // no LCP query needed
+    } else {
+      batch.add(symb_pos + 1, pos + 1, symb);
+      if (batch.size() == cLCP_batch_size) {
+        fill_batched_cells(batch);
+      }
+    }
+  } // This cell filled
+}
+
+void Search::fill_batched_cells(Search::LCP_batch &batch) {
+  getLCPs(batch, _fwd_search_ds);
+  for (UINT q = 0; q < batch.size(); ++q) {
+    UINT symb = batch.tag[q];
+    UINT pos = batch.suff2[q] - 1;
+    // It may have been filled (recursively) by a cell before it in the batch
+    if (_longest_degenerate_prefix.get(symb, pos) == -1) {
+      fill_longest_degenerate_match(symb, pos, batch.lcp[q]);
+    }
+  }
+  batch.clear();
+}
+
+void Search::fill_table_by_diagonals() {
+  // The lcp of a symbol with itself is set to 0 (diagonal 0)
+  for (UINT symb = 0; symb < _k; ++symb) {
+    _longest_degenerate_prefix.set(symb, _degenerate_indices[symb], 0);
+  }
+  // A diagonal writes only its own cells; so no two threads share a cell
+#pragma omp parallel for schedule(dynamic) num_threads(_options.num_threads)
+  for (INT diag = 1; diag < _seq_size; ++diag) {
+    fill_diagonal(diag);
+  }
+}
+
+void Search::fill_diagonal(const UINT diag) {
+  // Pairs (p, p+diag) with a degenerate symbol at p or at p+diag are visited
+  // in the descending order of p by merging the two (descending) lists
+  INT first_ind = std::upper_bound(_degenerate_indices.begin(),
+                                   _degenerate_indices.end(),
+                                   _seq_size - 1 - diag) -
+                  _degenerate_indices.begin() - 1; // symbol at p
+  INT second_ind = static_cast<INT>(_k) - 1;      // symbol at p+diag
+  while (true) {
+    INT first_p = (first_ind >= 0)
+                      ? (static_cast<INT>(_degenerate_indices[first_ind]))
+                      : (-1);
+    INT second_p = (second_ind >= 0)
+                       ? (static_cast<INT>(_degenerate_indices[second_ind]) -
+                          static_cast<INT>(diag))
+                       : (-1);
+    if (first_p < 0 && second_p < 0) {
+      break; // diagonal done
+    }
+    UINT pos1 = std::max(first_p, second_p);
+    UINT pos2 = pos1 + diag;
+    /* Find match */
+    INT longest_match = 0;
+    if (_dgs.is_match(pos1, pos2)) { // extend match
+      longest_match = 1 + getLCP(pos1 + 1, pos2 + 1, _fwd_search_ds);
+      UINT new_pos1 = pos1 + longest_match;
+      UINT new_pos2 = pos2 + longest_match;
+      if (new_pos2 < _seq_size) {
+        // Its cell (if any) is further along this diagonal; already filled
+        if (_dgs.is_degenerate(new_pos1) || _dgs.is_degenerate(new_pos2)) {
+          longest_match += get_degenerate_prefix(new_pos1, new_pos2);
+        }
+      }
+    }
+    /* Fill the cell/s */
+    if (first_p == pos1) {
+      _longest_degenerate_prefix.set(first_ind, pos2, longest_match);
+      --first_ind;
+    }
+    if (second_p == pos1) {
+      _longest_degenerate_prefix.set(second_ind, pos1, longest_match);
+      --second_ind;
+    }
+  }
+}
+
+INT Search::get_degenerate_prefix(const UINT pos1, const UINT pos2) const {
+  if (_dgs.is_degenerate(pos1)) {
+    return _longest_degenerate_prefix.get(_dgs.get_symbol_index(pos1), pos2);
+  }
+  return _longest_degenerate_prefix.get(_dgs.get_symbol_index(pos2), pos1);
+}
+
+INT Search::get_longest_degenerate_prefix(const UINT symb, const UINT pos) {
+  if (_options.fill_type != FillType::LAZY) {
+    return _longest_degenerate_prefix.get(symb, pos);
+  }
+  INT k_lcp = _longest_degenerate_prefix.get(symb, pos);
+  if (k_lcp == -1) { // The cell is uninitalised
+    auto symb_pos = _degenerate_indices[symb];
+    if (pos == symb_pos || !_dgs.is_match(symb_pos, pos)) {
+      return 0; // Nothing to remember for a mismatch
+    }
+    // Nor for a match ending before the following degenerate symbols (of
+    // either position): it takes one LCP query; only the cells of chains
+    // are stored (so only their pages of the table are touched)
+    INT lcp = getLCP(symb_pos + 1, pos + 1, _fwd_search_ds);
+    UINT new_pos1 = symb_pos + 1 + lcp;
+    UINT new_pos2 = pos + 1 + lcp;
+    if (new_pos1 >= _seq_size || new_pos2 >= _seq_size ||
+        (!_dgs.is_degenerate(new_pos1) && !_dgs.is_degenerate(new_pos2))) {
+      return 1 + lcp;
+    }
+    fill_longest_degenerate_match(symb, pos, lcp);
+    k_lcp = _longest_degenerate_prefix.get(symb, pos);
+  }
+  return k_lcp;
+}
+
+// Assumes symb_ind is always for a degenerate symbol
+void Search::fill_longest_degenerate_match(const UINT symb_ind,
+                                           const UINT pos2,
+                                           const INT known_lcp) {
+  std::vector<Chain_link> &chain = _chains[omp_get_thread_num()];
+  chain.clear();
+  /* Follow the chain */
+  UINT symb = symb_ind;
+  UINT pos = pos2;
+  INT lcp = known_lcp;
+  INT longest_match = 0; // match of the cell the chain ends at
+  while (true) {
+    auto symb_pos = _degenerate_indices[symb];
+    /* Find match */
+    INT match = 0;
+    bool extended = false;
+    // As at least one symbol is degenerate, ask for approx match at this
+    // position
+    if (_dgs.is_match(symb_pos, pos)) { // these positions match; extend match
+      match = 1;                        // match is at least 1
+      // If any of the positions exceeds the size, lcp will be returned as 0
+      match += (lcp >= 0) ? (lcp) : (getLCP(symb_pos + 1, pos + 1,
+                                            _fwd_search_ds));
+      UINT new_pos1 = symb_pos + match;
+      UINT new_pos2 = pos + match;
+      // any new position goes outside string or both are in seed, we are done
+      // otherwise, the match continues by that of the cell of the new
+      // positions.
+      if ((new_pos1 < _seq_size) && (new_pos2 < _seq_size)) {
+        bool new_pos1_deg = _dgs.is_degenerate(new_pos1);
+        if (new_pos1_deg || _dgs.is_degenerate(new_pos2)) {
+          chain.push_back({symb, pos, match});
+          symb = (new_pos1_deg) ? (_dgs.get_symbol_index(new_pos1))
+                                : (_dgs.get_symbol_index(new_pos2));
+          pos = (new_pos1_deg) ? (new_pos2) : (new_pos1);
+          longest_match = _longest_degenerate_prefix.get(symb, pos);
+          if (longest_match == -1) { // the chain goes on at this cell
+            lcp = -1;
+            continue;
           }
+          extended = true;
         }
-        fill_longest_degenerate_match(new_index1, new_index2);
       }
-      longest_match += _longest_degenerate_prefix[new_symb_ind][pos];
     }
+    if (!extended) { // the chain ends at this cell
+      chain.push_back({symb, pos, match});
+      longest_match = 0;
+    }
+    break;
+  }
+
+  /* Fill the cell/s (from the end of the chain) */
+  for (auto link = chain.rbegin(); link != chain.rend(); ++link) {
+    longest_match += link->match;
+    _longest_degenerate_prefix.set(link->symb, link->pos, longest_match);
+    // If the second position is also degenerate, fill the corresponding cell
+    // It will definitely be -1; otherwise the second symbol would have
+    // already filled this cell
+    if (_dgs.is_degenerate(link->pos)) {
+      _longest_degenerate_prefix.set(_dgs.get_symbol_index(link->pos),
+                                     _degenerate_indices[link->symb],
+                                     longest_match);
+    }
+#ifdef DEBUG
+    // PRINTING FOR DEBUGGING
+    std::cout << "FILLED CELL: symb_ind pos: " << link->symb << "  "
+              << link->pos << std::endl;
+#endif
+  }
+  Chain_stats &stats = _chain_stats[omp_get_thread_num()];
+  ++stats.num_chains;
+  stats.num_cells += chain.size();
+  stats.longest = std::max<UINT>(stats.longest, chain.size());
+}
+
+Search::Chain_stats Search::get_chain_stats() const {
+  Chain_stats total;
+  for (const auto &stats : _chain_stats) {
+    total.add(stats);
+  }
+  return total;
+}
+
+void Search::fill_type2_table(const UINT block,
+                              std::vector<UINT> &type2_result) {
+  // Type 2 mode is entered at the first position of the block whose solid
+  // match ends just before the following degenerate symbol
+  auto following_symb_pos = _degenerate_indices[block];
+  auto first_pos = _seed_offsets[block];
+  UINT solid_l = 0;
+  UINT min_solid_l = 0; // the smallest one read (at the last such position)
+  bool type2 = false;
+  for (auto i = first_pos; i < following_symb_pos; ++i) {
+    if (i + _solid_lpf[i] == following_symb_pos) {
+      if (!type2) {
+        solid_l = _solid_lpf[i];
+        type2 = true;
+      }
+      min_solid_l = _solid_lpf[i];
+    }
+  }
+  if (!type2) { // no position of this block needs it
+    return;
   }
-  /* Fill the cell/s */
-  _longest_degenerate_prefix[symb_ind][pos2] = longest_match;
-  // If the second position is also degenerate, fill the corresponding cell
-  // It will definitely be -1; otherwise the second symbol would have already
-  // filled this cell
-  // And we wouldn't have been in this call.
-  if (!index2.is_seed) {
-    _longest_degenerate_prefix[index2.index][symb_pos] = longest_match;
+  std::vector<UINT> type2_local(solid_l + 1, 0);
+
+  auto rev_last_pos = _seq_size - following_symb_pos;
+  if (_options.backward_lce == BackwardLce::REVERSE_INDEX) {
+    // Only the lengths of the solid matches are read; so only occurrences
+    // whose reverse lcp is at least the smallest of them are needed. They are
+    // consecutive in the reverse suffix array around the rank of the last
+    // letter of the seed (the reverse lcp being the running minimum of the
+    // lcp array)
+    // (With a shared index, the occurrences in other sequences are skipped)
+    const Search_index &index = *_rev_search_ds.index;
+    const UINT offset = _rev_search_ds.offset;
+    auto add_occurrence = [&](const UINT rank, const UINT rev_lcp) {
+      UINT p = index.sa(rank) - offset; // wraps around if before the sequence
+      if (p > rev_last_pos && p < _seq_size) { // occurrence precedes the seed
+        add_type2_candidate(block, p, rev_lcp, type2_local);
+      }
+    };
+    UINT rank = index.isa(offset + rev_last_pos);
+    UINT rev_lcp = _seq_size;
+    for (UINT r = rank; r > 0; --r) { // preceding ranks
+      rev_lcp = std::min(rev_lcp, index.lcp(r));
+      if (rev_lcp < min_solid_l) {
+        break;
+      }
+      add_occurrence(r - 1, rev_lcp);
+    }
+    rev_lcp = _seq_size;
+    for (UINT r = rank + 1; r < index.size(); ++r) { // following ranks
+      rev_lcp = std::min(rev_lcp, index.lcp(r));
+      if (rev_lcp < min_solid_l) {
+        break;
+      }
+      add_occurrence(r, rev_lcp);
+    }
+  } else {
+    find_type2_candidates_by_z_array(block, type2_local);
   }
+  type2_result = std::move(type2_local);
 #ifdef DEBUG
   // PRINTING FOR DEBUGGING
-  std::cout << "FILLED CELL: symb_ind pos: " << symb_ind << "  " << pos2
-            << std::endl;
+  std::cout << "L-Table : " << block << std::endl;
+  for (auto c : type2_result) {
+    std::cout << c << " ";
+  }
+  std::cout << std::endl;
 #endif
 }
 
+void Search::find_type2_candidates_by_z_array(const UINT block,
+                                              std::vector<UINT> &type2_local) {
+  auto following_symb_pos = _degenerate_indices[block];
+  auto first_pos = _seed_offsets[block];
+  ENCODED_CHAR c = _dgs.get_seed_lastletter(block);
+  // Without the reverse index: backward extensions are matches of the
+  // reversed seed (before its last letter) in the reversed sequence before it
+  std::vector<UINT> backward_match;
+  UINT seed_end = following_symb_pos - 2; // the letter before the last one
+  bool extend = following_symb_pos >= first_pos + 2;
+  if (extend) {
+    std::vector<ENCODED_CHAR> pattern_text;
+    pattern_text.reserve(following_symb_pos + 1);
+    for (INT pos = seed_end; pos >= static_cast<INT>(first_pos); --pos) {
+      pattern_text.push_back(_symbols[pos]);
+    }
+    pattern_text.push_back(~ENCODED_CHAR(0)); // unique separator
+    for (INT pos = static_cast<INT>(seed_end) - 1; pos >= 0; --pos) {
+      pattern_text.push_back(_symbols[pos]);
+    }
+    z_array(pattern_text, backward_match);
+    // backward match from a position a is at (seed_end - first_pos + 2) +
+    // (seed_end - 1 - a)
+  }
+  auto rev_last_pos = _seq_size - following_symb_pos;
+  // for each occurrence (succeeding) of letter in reverse, find
+  // potential longer lpf
+  // The cells of the tails are strided in the position-major layout; they are
+  // prefetched a few occurrences ahead
+  auto occ_begin = _letter_ind_in_rev.begin() + _letter_offsets[c];
+  auto occ_end = _letter_ind_in_rev.begin() + _letter_offsets[c + 1];
+  for (auto occ = occ_begin; occ != occ_end && *occ > rev_last_pos; ++occ) {
+    auto ahead = occ + cPrefetch_distance;
+    if (ahead < occ_end && *ahead > rev_last_pos) {
+      _longest_degenerate_prefix.prefetch(block, _seq_size - *ahead);
+    }
+    auto p = *occ;
+    UINT rev_lcp = 1;
+    if (extend && (p + 1 < _seq_size)) { // Take rev-lpf if  there are solid
+      // letters preceeding it in the seed
+      UINT a = _seq_size - 2 - p; // forward position before occurrence
+      rev_lcp += backward_match[2 * seed_end - first_pos + 1 - a];
+    }
+    add_type2_candidate(block, p, rev_lcp, type2_local);
+  }
+}
+
+void Search::add_type2_candidate(const UINT block, const UINT p,
+                                 const UINT rev_lcp,
+                                 std::vector<UINT> &type2_local) {
+  // find tail of the match
+  auto tail_match = 0;
+  auto reverse_next_p = _seq_size - p;
+  if (reverse_next_p < _seq_size) {
+    tail_match = get_longest_degenerate_prefix(block, reverse_next_p);
+  }
+  UINT potential_lpf = rev_lcp + tail_match;
+
+  // update the lpf-value of the corresponding length
+  type2_local[rev_lcp] = std::max(type2_local[rev_lcp], potential_lpf);
+}
+
 ReturnStatus Search::setup_ds() {
-  const SEEDS &seeds = _dgs.get_seeds();
-  UINT num_seeds = seeds.size();
-  UINT delimiter = _dgs.get_alphabet_size() + 1;
+  const std::vector<ENCODED_CHAR> &symbols = _dgs.get_symbols();
+  UINT first_delimiter = _dgs.get_alphabet_size() + 1;
   // Combine all seeds, replacing degenerate symbols with distinct unique
   // symbols (not in alphabet)
-  std::string seq(_seq_size, 0);
+  // Integer alphabet: wide enough for the alphabet and one symbol per seed
+  uint8_t width = sdsl::bits::hi(first_delimiter + _k + 1) + 1;
+  // (Not needed with a shared index)
+  bool own_index = (_shared_index == nullptr);
+  sdsl::int_vector<> seq(own_index ? _seq_size : 0, 0, width);
   // Take reverse of the combined sequence for the reverse LCP queries
-  std::string rev_seq(_seq_size, 0);
-  UINT fwd = 0;
+  bool reverse_index =
+      own_index && _options.backward_lce == BackwardLce::REVERSE_INDEX;
+  sdsl::int_vector<> rev_seq(reverse_index ? _seq_size : 0, 0, width);
+  // Remember the indices of occurrences of each character (counted first)
+  for (auto c : symbols) {
+    if (!(c & cDegenerate_marker)) {
+      ++_letter_offsets[c + 1];
+    }
+  }
+  for (UINT c = 1; c < _letter_offsets.size(); ++c) {
+    _letter_offsets[c] += _letter_offsets[c - 1];
+  }
+  _letter_ind_in_rev.resize(_letter_offsets.back());
+  std::vector<UINT> next_ind(_letter_offsets.begin(),
+                             _letter_offsets.end() - 1);
   UINT rev = _seq_size - 1;
-  for (auto ind = 0; ind < num_seeds; ++ind) {
-    for (auto c : seeds[ind]) {
-      seq[fwd++] = static_cast<unsigned char>(c);
-      _letter_ind_in_rev[c].push_back(
-          rev); // Remember the indices of occurrences of each character
-      rev_seq[rev--] = static_cast<unsigned char>(c);
-    }
-    if (ind < num_seeds - 1) { // Seed followed by lambda_i except the last seed
-      if (delimiter > cMAxUniqueSymbol) {
-        std::cerr << "Invalid Input: Sequence has more than allowed degenerate "
-                     "symbols.: (allowed: "
-                  << cMAxUniqueSymbol << " found: " << delimiter << std::endl;
-      }
-
-      seq[fwd++] = static_cast<unsigned char>(delimiter);
-      rev_seq[rev--] = static_cast<unsigned char>(delimiter);
-      ++delimiter;
+  for (UINT fwd = 0; fwd < _seq_size; ++fwd, --rev) {
+    auto c = symbols[fwd];
+    if (c & cDegenerate_marker) { // degenerate symbol
+      c = first_delimiter + (c & ~cDegenerate_marker);
+    } else {
+      _letter_ind_in_rev[next_ind[c]++] = rev;
+    }
+    if (own_index) {
+      seq[fwd] = c;
+    }
+    if (reverse_index) {
+      rev_seq[rev] = c;
     }
   }
 #ifdef DEBUG
   // PRINTING FOR DEBUGGING
   std::cout << "SOLID SEQUENCE: \n";
   for (auto c : seq) {
-    std::cout << (int)c << " ";
+    std::cout << c << " ";
   }
   std::cout << std::endl;
 #endif
-  ds_helper(seq, _fwd_search_ds);
-  ds_helper(rev_seq, _rev_search_ds);
+  if (own_index) {
+    // The reverse one is built concurrently (if there are threads for it)
+    ds_helper(_fwd_search_ds);
+    if (reverse_index) {
+      ds_helper(_rev_search_ds);
+    }
+    build_search_indexes(*_fwd_search_ds.own_index, seq,
+                         _rev_search_ds.own_index.get(), rev_seq,
+                         _options.build_threads);
+  } else {
+    _fwd_search_ds.index = &_shared_index->get_forward_index();
+    _fwd_search_ds.offset = _shared_index->get_offset(_shared_str);
+    _rev_search_ds.index = _shared_index->get_reverse_index();
+    _rev_search_ds.offset = _shared_index->get_reverse_offset(_shared_str);
+  }
+  _fwd_search_ds.is_reverse = false;
+  _rev_search_ds.is_reverse = true;
   return ReturnStatus::SUCCESS;
 }
 
 ReturnStatus Search::find_solid_lpf() {
-  std::vector<INT> prev(_seq_size + 1, 0);
-  std::vector<INT> next(_seq_size + 1, 0);
-  std::vector<UINT> lcp(_seq_size + 1, 0);
-  for (auto i = 0; i < _seq_size; ++i) {
-    lcp[i] = _fwd_search_ds.lcp[i];
-    prev[i] = i - 1;
-    next[i] = i + 1;
-  }
-  auto r = 0;
-  for (int i = _seq_size - 1; i >= 0; --i) {
-    r = _fwd_search_ds.csa.isa[i];
-    _solid_lpf[i] = std::max(lcp[r], lcp[next[r]]);
-    lcp[next[r]] = std::min(lcp[r], lcp[next[r]]);
-    if (prev[r] >= 0) {
-      next[prev[r]] = next[r];
+  const Search_index &index = *_fwd_search_ds.index;
+  std::vector<UINT> rank_of(_seq_size, 0);
+  std::vector<UINT> lcp;
+  if (_shared_index == nullptr) {
+    // All the ranks of the index (and the one of the sentinel)
+    lcp.assign(_seq_size + 2, 0);
+    for (UINT r = 0; r <= _seq_size; ++r) {
+      lcp[r] = index.lcp(r);
     }
-    if (next[r] < _seq_size) {
-      prev[next[r]] = prev[r];
+    for (UINT i = 0; i < _seq_size; ++i) {
+      rank_of[i] = index.isa(i);
+    }
+  } else {
+    // The ranks of this sequence (consecutive in the order of the index)
+    const std::vector<UINT> &ranks = _shared_index->get_ranks();
+    UINT first = _shared_index->get_rank_offsets()[_shared_str];
+    lcp.assign(_seq_size + 1, 0);
+    for (UINT r = 0; r < _seq_size; ++r) {
+      if (r > 0) {
+        lcp[r] = index.lce_of_ranks(ranks[first + r - 1], ranks[first + r]);
+      }
+      rank_of[index.sa(ranks[first + r]) - _fwd_search_ds.offset] = r;
     }
   }
+  lpf_simple(rank_of, lcp, _solid_lpf);
   return ReturnStatus::SUCCESS;
 }
 
-void Search::ds_helper(const std::string &seq, Search::SearchDS &searchds) {
-  // sdsl::construct_im(searchds.csa, patternstr, 1); // 1 for alphabet type
-  // std::cout << " i SA ISA T[SA[i]..SA[i]-1]" << std::endl;
-  // sdsl::csXprintf(std::cout, "%2I %2S %3s %:3T", csa);
-  // qsufsort::construct_sa(csa, );
-  sdsl::construct_im(searchds.csa, seq, 1); // 1 for alpahabet type
-  sdsl::construct_im(searchds.lcp, seq, 1); // 1 for alphabet type
-  searchds.rmq = std::move(sdsl::rmq_succinct_sct<>(&(searchds.lcp)));
-  // RMQ rmq(&(searchds.lcp));
-  // rmq does not need its arg to answer the queries
-  // sdsl::util::clear(lcp); // so we can free the space for v
+void Search::ds_helper(Search::SearchDS &searchds) {
+  searchds.own_index = make_search_index(_options.index_profile);
+  searchds.index = searchds.own_index.get();
+  searchds.offset = 0;
 }
 
-UINT Search::find_longest_degenerate_match(const INDEX &index1,
-                                           const INDEX &index2) const {
-  // Map indices into sequence positions
-  UINT pos1 = 0;
-  UINT pos1_next_symb_ind = index1.index;
-  if (index1.is_seed) { // solid position
-    auto block = index1.index;
-    auto base = (block == 0) ? (0) : (_degenerate_indices[block - 1] + 1);
-    pos1 = base + index1.inseed_index;
-  } else { // degenerate symbol
-    pos1 = _degenerate_indices[index1.index];
-    ++pos1_next_symb_ind;
-  }
-  UINT pos2 = 0;
-  UINT pos2_next_symb_ind = index2.index;
-  if (index2.is_seed) { // solid position
-    auto block = index2.index;
-    auto base = (block == 0) ? (0) : (_degenerate_indices[block - 1] + 1);
-    pos2 = base + index2.inseed_index;
-  } else { // degenerate symbol
-    pos2 = _degenerate_indices[index2.index];
-    ++pos2_next_symb_ind;
-  }
-  /* Find match */
+UINT Search::find_longest_degenerate_match(UINT pos1, UINT pos2) const {
   UINT longest_match = 0;
-  // if any of the symbol is degenerate, first test the letters
-  if (!index1.is_seed || !index2.is_seed) {
-    if (_dgs.is_match(index1, index2)) { // these positions match; extend match
-      longest_match += 1;                // match is at least 1
+  while (pos1 < _seq_size && pos2 < _seq_size) {
+    // if any of the symbol is degenerate, test the letters
+    if (_dgs.is_degenerate(pos1) || _dgs.is_degenerate(pos2)) {
+      if (!_dgs.is_match(pos1, pos2)) { // no match at this position
+        break;
+      }
+      longest_match += 1; // these positions match; extend match
       ++pos1;
       ++pos2;
-    } else { // no match at this position
-      return longest_match;
+      continue;
     }
-  }
-
-  while (pos1 < _seq_size && pos2 < _seq_size) {
     // If any of the positions exceeds the size, lcp will be returned as 0
     auto lcp = getLCP(pos1, pos2, _fwd_search_ds);
     longest_match += lcp;
     pos1 += lcp;
     pos2 += lcp;
-    auto next_stop_pos1 = (pos1_next_symb_ind < _k)
-                              ? (_degenerate_indices[pos1_next_symb_ind])
-                              : (_seq_size);
-    auto next_stop_pos2 = (pos2_next_symb_ind < _k)
-                              ? (_degenerate_indices[pos2_next_symb_ind])
-                              : (_seq_size);
-    // any of the new positions goes outside string or both are in seed, we are
-    // done; otherwise, continue extending
-    bool is_pos1_deg = (pos1 == next_stop_pos1);
-    bool is_pos2_deg = (pos2 == next_stop_pos2);
-    if ((pos1 < _seq_size) && (pos2 < _seq_size) &&
-        (is_pos1_deg || is_pos2_deg)) {
-      // Get the INDEX structutres from the pos (for checking match)
-      INDEX new_index1;
-      if (is_pos1_deg) { // Index1 is degenerate
-        new_index1 = INDEX{false, pos1_next_symb_ind, 0};
-        ++pos1_next_symb_ind;
-      } else { // Index1 is in seeed
-        auto base = (pos1_next_symb_ind == 0)
-                        ? (0)
-                        : (_degenerate_indices[pos1_next_symb_ind - 1] + 1);
-        new_index1 = INDEX{true, pos1_next_symb_ind, pos1 - base};
-      }
-      INDEX new_index2;
-      if (is_pos2_deg) { // Index2 is degenerate
-        new_index2 = INDEX{false, pos2_next_symb_ind, 0};
-        ++pos2_next_symb_ind;
-      } else { // Index2 is in seeed
-        auto base = (pos2_next_symb_ind == 0)
-                        ? (0)
-                        : (_degenerate_indices[pos2_next_symb_ind - 1] + 1);
-        new_index2 = INDEX{true, pos2_next_symb_ind, pos2 - base};
-      }
-      // As at least one symbol is degenerate, ask for approx match at this
-      // position
-      if (_dgs.is_match(new_index1,
-                        new_index2)) { // these positions match; extend match
-        longest_match += 1;            // match is at least 1
-        ++pos1;
-        ++pos2;
-      } else { // no match at this position
-        break;
-      }
-    } else { // both real mismatches or hit the end of the string
+    // both real mismatches (hitting the end of the string ends the loop)
+    if (pos1 < _seq_size && pos2 < _seq_size && !_dgs.is_degenerate(pos1) &&
+        !_dgs.is_degenerate(pos2)) {
       break;
     }
   }
   return longest_match;
 }
 
-// Assumption: csa, lcp, rmq are valid (only size is being checked)
+// Assumption: the index has been built
 // If any index > length of the sequence, returns 0
 INT Search::getLCP(const INT suff1, const INT suff2,
                    const Search::SearchDS &searchds) const {
-  assert(!searchds.csa.empty());
-  assert(!searchds.lcp.empty());
-  assert(searchds.rmq.size() > 0);
   if (suff1 >= _seq_size || suff2 >= _seq_size) {
     return 0;
   }
-  INT l_rmq, r_rmq;
-  INT r1 = searchds.csa.isa[suff1];
-  INT r2 = searchds.csa.isa[suff2];
-  if (r1 < r2) {
-    l_rmq = r1;
-    r_rmq = r2;
+  if (suff1 == suff2) {
+    return _seq_size - suff1;
+  }
+  UINT lcp = 0;
+  if (get_direct_LCP(suff1, suff2, searchds, lcp)) {
+    return lcp;
+  }
+  return searchds.index->lce(searchds.offset + suff1,
+                             searchds.offset + suff2);
+}
+
+void Search::getLCPs(Search::LCP_batch &batch,
+                     const Search::SearchDS &searchds) const {
+  UINT count = batch.size();
+  batch.lcp.resize(count);
+  batch.pending.clear();
+  for (UINT q = 0; q < count; ++q) {
+    UINT suff1 = batch.suff1[q];
+    UINT suff2 = batch.suff2[q];
+    if (suff1 >= _seq_size || suff2 >= _seq_size) {
+      batch.lcp[q] = 0;
+    } else if (suff1 == suff2) {
+      batch.lcp[q] = _seq_size - suff1;
+    } else if (!get_direct_LCP(suff1, suff2, searchds, batch.lcp[q])) {
+      batch.pending.push_back(q);
+    }
+  }
+  // Pipeline: the ranks are prefetched 2d queries ahead; d queries ahead, they
+  // are read and what their range minimum query reads is prefetched
+  const Search_index &index = *searchds.index;
+  const UINT d = cPrefetch_distance;
+  UINT num_pending = batch.pending.size();
+  batch.rank1.resize(num_pending);
+  batch.rank2.resize(num_pending);
+  const UINT offset = searchds.offset;
+  auto prefetch_isa = [&](const UINT p) {
+    index.prefetch_isa(offset + batch.suff1[batch.pending[p]]);
+    index.prefetch_isa(offset + batch.suff2[batch.pending[p]]);
+  };
+  auto read_ranks = [&](const UINT p) {
+    batch.rank1[p] = index.isa(offset + batch.suff1[batch.pending[p]]);
+    batch.rank2[p] = index.isa(offset + batch.suff2[batch.pending[p]]);
+    index.prefetch_ranks(batch.rank1[p], batch.rank2[p]);
+  };
+  for (UINT p = 0; p < std::min(num_pending, 2 * d); ++p) {
+    prefetch_isa(p);
+  }
+  for (UINT p = 0; p < std::min(num_pending, d); ++p) {
+    read_ranks(p);
+  }
+  for (UINT p = 0; p < num_pending; ++p) {
+    if (p + 2 * d < num_pending) {
+      prefetch_isa(p + 2 * d);
+    }
+    if (p + d < num_pending) {
+      read_ranks(p + d);
+    }
+    batch.lcp[batch.pending[p]] =
+        index.lce_of_ranks(batch.rank1[p], batch.rank2[p]);
+  }
+}
+
+// Assumes the suffixes to be distinct and smaller than the sequence size
+bool Search::get_direct_LCP(const UINT suff1, const UINT suff2,
+                            const Search::SearchDS &searchds,
+                            UINT &lcp) const {
+  // Most matches are short: compare the first few symbols directly
+  // (delimiters of the solid sequence are the markers of the flat sequence)
+  UINT max_lcp = _seq_size - std::max(suff1, suff2);
+  UINT window = std::min(max_lcp, cDirect_lce_window);
+  if (searchds.is_reverse) {
+    lcp = direct_lce_backward(&_symbols[_seq_size - 1 - suff1],
+                              &_symbols[_seq_size - 1 - suff2], window);
   } else {
-    l_rmq = r2;
-    r_rmq = r1;
+    lcp = direct_lce(&_symbols[suff1], &_symbols[suff2], window);
   }
-  INT minIndex = searchds.rmq(l_rmq + 1, r_rmq);
-  INT lcp = searchds.lcp[minIndex];
-  return lcp;
-  // std::cout << "LCP: "<< lcp << std::endl;
+  return lcp < window || window == max_lcp;
 }
 
 } // end namespace
@@ -0,0 +1,92 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements the indexes of class Search_index
+ */
+#include "../include/Search_index.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace deglpf {
+
+std::string unique_construction_id() {
+  static std::atomic<uint64_t> next_id(0);
+  return sdsl::util::to_string(sdsl::util::pid()) + "_deglpf_" +
+         sdsl::util::to_string(next_id++);
+}
+
+void Fast_search_index::build(const sdsl::int_vector<> &seq,
+                              const UINT num_threads) {
+  if (num_threads > 1) {
+    construct_suffix_array(seq, num_threads, _sa);
+    construct_lcp_array(seq, _sa, num_threads, _lcp);
+  } else {
+    // The arrays are built by SDSL and unpacked
+    sdsl::csa_bitcompressed<sdsl::int_alphabet<>> csa;
+    sdsl::lcp_bitcompressed<> lcp;
+    construct_in_memory(csa, lcp, seq, num_threads);
+    _sa.assign(csa.begin(), csa.end());
+    _lcp.assign(lcp.begin(), lcp.end());
+  }
+  INT n = _sa.size(); // including the sentinel appended by SDSL
+  _isa.assign(n, 0);
+#pragma omp parallel for num_threads(num_threads)
+  for (INT r = 0; r < n; ++r) {
+    _isa[_sa[r]] = r;
+  }
+  UINT num_levels = (n > 1) ? (sdsl::bits::hi(n - 1) + 1) : (1);
+  _minima.assign(static_cast<uint64_t>(num_levels) * n, 0);
+  std::copy(_lcp.begin(), _lcp.end(), _minima.begin());
+  for (UINT level = 1; level < num_levels; ++level) {
+    uint32_t *minima = &_minima[static_cast<uint64_t>(level) * n];
+    const uint32_t *prev = minima - n;
+    INT half = 1U << (level - 1);
+#pragma omp parallel for num_threads(num_threads)
+    for (INT i = 0; i <= n - 2 * half; ++i) {
+      minima[i] = std::min(prev[i], prev[i + half]);
+    }
+  }
+}
+
+void build_search_indexes(Search_index &index, const sdsl::int_vector<> &seq,
+                          Search_index *other_index,
+                          const sdsl::int_vector<> &other_seq,
+                          const UINT num_threads) {
+  if (other_index == nullptr) {
+    index.build(seq, num_threads);
+  } else if (num_threads == 1) {
+    index.build(seq, 1);
+    other_index->build(other_seq, 1);
+  } else {
+    // The other one is built by a thread of its own (with its own team)
+    UINT half = std::max<UINT>(num_threads / 2, 1);
+    std::thread other_builder(
+        [&]() { other_index->build(other_seq, num_threads - half); });
+    index.build(seq, half);
+    other_builder.join();
+  }
+}
+
+std::unique_ptr<Search_index> make_search_index(const IndexProfile profile) {
+  if (profile == IndexProfile::FAST) {
+    return std::unique_ptr<Search_index>(new Fast_search_index());
+  } else if (profile == IndexProfile::COMPACT) {
+    return std::unique_ptr<Search_index>(new Compact_search_index());
+  }
+  return std::unique_ptr<Search_index>(new Succinct_search_index());
+}
+
+} // end namespace
@@ -0,0 +1,87 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements class Shared_index
+ */
+#include "../include/Shared_index.hpp"
+
+namespace deglpf {
+
+Shared_index::Shared_index(
+    const std::vector<const Degenerate_string *> &strings,
+    const SearchOptions &options)
+    : _offsets(strings.size(), 0), _lengths(strings.size(), 0), _size(1),
+      _rank_offsets(strings.size() + 1, 0) {
+  UINT num_strings = strings.size();
+  UINT alphabet_size = 0;
+  UINT num_symbols = 0;
+  for (UINT s = 0; s < num_strings; ++s) {
+    alphabet_size = std::max(alphabet_size, strings[s]->get_alphabet_size());
+    num_symbols += strings[s]->get_numberof_seeds() - 1;
+    // Each string is followed by a separator
+    _offsets[s] = _size;
+    _lengths[s] = strings[s]->get_size();
+    _size += _lengths[s] + 1;
+    _rank_offsets[s + 1] = _rank_offsets[s] + _lengths[s];
+  }
+  // Letters, then the degenerate symbols of all the strings, then the
+  // separators (one before each string and one at the end)
+  UINT first_delimiter = alphabet_size + 1;
+  UINT first_separator = first_delimiter + num_symbols;
+  uint8_t width = sdsl::bits::hi(first_separator + num_strings) + 1;
+  sdsl::int_vector<> seq(_size, 0, width);
+  // String of each position (num_strings for a separator)
+  std::vector<UINT> string_of(_size, num_strings);
+  UINT first_symbol = 0;
+  for (UINT s = 0; s < num_strings; ++s) {
+    seq[_offsets[s] - 1] = first_separator + s;
+    const std::vector<ENCODED_CHAR> &symbols = strings[s]->get_symbols();
+    for (UINT i = 0; i < _lengths[s]; ++i) {
+      auto c = symbols[i];
+      if (c & cDegenerate_marker) { // degenerate symbol
+        c = first_delimiter + first_symbol + (c & ~cDegenerate_marker);
+      }
+      seq[_offsets[s] + i] = c;
+      string_of[_offsets[s] + i] = s;
+    }
+    first_symbol += strings[s]->get_numberof_seeds() - 1;
+  }
+  seq[_size - 1] = first_separator + num_strings;
+
+  _fwd_index = make_search_index(options.index_profile);
+  sdsl::int_vector<> rev_seq;
+  if (options.backward_lce == BackwardLce::REVERSE_INDEX) {
+    rev_seq.width(width);
+    rev_seq.resize(_size);
+    for (UINT i = 0; i < _size; ++i) {
+      rev_seq[_size - 1 - i] = seq[i];
+    }
+    _rev_index = make_search_index(options.index_profile);
+  }
+  build_search_indexes(*_fwd_index, seq, _rev_index.get(), rev_seq,
+                       options.build_threads);
+
+  // Ranks of each string, by one pass over the suffix array
+  _ranks.resize(_rank_offsets[num_strings]);
+  std::vector<UINT> next_rank(_rank_offsets.begin(), _rank_offsets.end() - 1);
+  for (UINT r = 0; r <= _size; ++r) { // the sentinel of SDSL too
+    UINT p = _fwd_index->sa(r);
+    if (p < _size && string_of[p] < num_strings) {
+      _ranks[next_rank[string_of[p]]++] = r;
+    }
+  }
+}
+
+} // end namespace
@@ -0,0 +1,186 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements the construction of the suffix and LCP arrays
+ */
+#include "../include/Suffix_array.hpp"
+
+#include <omp.h>
+#include <parallel/algorithm>
+#include <sdsl/construct.hpp>
+
+namespace deglpf {
+
+namespace {
+// A suffix with the ranks of its first h and next h symbols
+struct Suffix_key {
+  uint64_t key;
+  uint32_t pos;
+
+  bool operator<(const Suffix_key &other) const { return key < other.key; }
+};
+
+// Rank of each suffix from the sorted keys: 1 + number of the distinct keys
+// before it; returns the number of the distinct keys
+UINT rank_suffixes(const std::vector<Suffix_key> &keys,
+                   std::vector<uint32_t> &rank, const UINT num_threads) {
+  UINT n = keys.size();
+  std::vector<UINT> distinct(num_threads + 1, 0); // per range of keys
+  UINT num_distinct = 0;
+#pragma omp parallel num_threads(num_threads)
+  {
+    UINT t = omp_get_thread_num();
+    UINT num_ranges = omp_get_num_threads();
+    UINT begin = static_cast<uint64_t>(n) * t / num_ranges;
+    UINT end = static_cast<uint64_t>(n) * (t + 1) / num_ranges;
+    UINT count = 0;
+    for (UINT j = begin; j < end; ++j) {
+      count += (j == 0 || keys[j].key != keys[j - 1].key);
+    }
+    distinct[t + 1] = count;
+#pragma omp barrier
+#pragma omp single
+    {
+      for (UINT r = 0; r < num_ranges; ++r) {
+        distinct[r + 1] += distinct[r];
+      }
+      num_distinct = distinct[num_ranges];
+    }
+    UINT current = distinct[t];
+    for (UINT j = begin; j < end; ++j) {
+      current += (j == 0 || keys[j].key != keys[j - 1].key);
+      rank[keys[j].pos] = current;
+    }
+  }
+  return num_distinct;
+}
+
+// Copies the values to the (bit-compressed) vector; ranges of 64 values do
+// not share a word, so they are copied concurrently
+void copy_values(const std::vector<uint32_t> &values, sdsl::int_vector<> &vec,
+                 const UINT num_threads) {
+  INT num_blocks = (values.size() + 63) / 64;
+#pragma omp parallel for num_threads(num_threads)
+  for (INT b = 0; b < num_blocks; ++b) {
+    UINT end = std::min<UINT>(values.size(), (b + 1) * 64);
+    for (UINT i = b * 64; i < end; ++i) {
+      vec[i] = values[i];
+    }
+  }
+}
+} // end anonymous namespace
+
+void construct_suffix_array(const sdsl::int_vector<> &seq,
+                            const UINT num_threads, std::vector<uint32_t> &sa) {
+  INT n = seq.size() + 1; // with the sentinel
+  // Rank 0 stands for a suffix shorter than h; the sentinel is the smallest
+  std::vector<uint32_t> rank(n, 1);
+#pragma omp parallel for num_threads(num_threads)
+  for (INT i = 0; i < n - 1; ++i) {
+    rank[i] = seq[i] + 1;
+  }
+  std::vector<Suffix_key> keys(n);
+  for (uint64_t h = 1;; h *= 2) {
+#pragma omp parallel for num_threads(num_threads)
+    for (INT i = 0; i < n; ++i) {
+      uint64_t next = (i + h < static_cast<uint64_t>(n)) ? (rank[i + h]) : (0);
+      keys[i].key = (static_cast<uint64_t>(rank[i]) << 32) | next;
+      keys[i].pos = i;
+    }
+    __gnu_parallel::sort(keys.begin(), keys.end(),
+                         __gnu_parallel::parallel_tag(num_threads));
+    if (rank_suffixes(keys, rank, num_threads) == static_cast<UINT>(n)) {
+      break; // all the suffixes are sorted
+    }
+  }
+  sa.resize(n);
+#pragma omp parallel for num_threads(num_threads)
+  for (INT j = 0; j < n; ++j) {
+    sa[j] = keys[j].pos;
+  }
+}
+
+void construct_lcp_array(const sdsl::int_vector<> &seq,
+                         const std::vector<uint32_t> &sa,
+                         const UINT num_threads, std::vector<uint32_t> &lcp) {
+  INT n = sa.size(); // with the sentinel
+  auto symbol = [&](const uint64_t i) -> uint64_t {
+    return (i + 1 < static_cast<uint64_t>(n)) ? (seq[i]) : (0);
+  };
+  // Phi: the suffix preceding each one in the suffix array (n if none); it
+  // is replaced by the permuted LCP array in place
+  std::vector<uint32_t> plcp(n);
+#pragma omp parallel for num_threads(num_threads)
+  for (INT j = 0; j < n; ++j) {
+    plcp[sa[j]] = (j > 0) ? (sa[j - 1]) : (n);
+  }
+  // The lcp decreases by at most one from a position to the next; each
+  // range of positions starts from 0
+#pragma omp parallel num_threads(num_threads)
+  {
+    UINT t = omp_get_thread_num();
+    UINT num_ranges = omp_get_num_threads();
+    UINT begin = static_cast<uint64_t>(n) * t / num_ranges;
+    UINT end = static_cast<uint64_t>(n) * (t + 1) / num_ranges;
+    UINT l = 0;
+    for (UINT i = begin; i < end; ++i) {
+      UINT phi = plcp[i];
+      if (phi == static_cast<UINT>(n)) {
+        plcp[i] = l = 0;
+        continue;
+      }
+      // The sentinel is unique; so the comparison stops before the end
+      while (symbol(i + l) == symbol(phi + l)) {
+        ++l;
+      }
+      plcp[i] = l;
+      if (l > 0) {
+        --l;
+      }
+    }
+  }
+  lcp.resize(n);
+#pragma omp parallel for num_threads(num_threads)
+  for (INT j = 0; j < n; ++j) {
+    lcp[j] = plcp[sa[j]];
+  }
+}
+
+void cache_suffix_arrays(const sdsl::int_vector<> &seq,
+                         const UINT num_threads, sdsl::cache_config &config) {
+  UINT n = seq.size() + 1; // with the sentinel
+  uint8_t width = sdsl::bits::hi(n) + 1;
+  std::vector<uint32_t> sa;
+  std::vector<uint32_t> lcp;
+  construct_suffix_array(seq, num_threads, sa);
+  construct_lcp_array(seq, sa, num_threads, lcp);
+  {
+    sdsl::int_vector<> text(seq);
+    sdsl::append_zero_symbol(text);
+    sdsl::store_to_cache(text, sdsl::key_text_trait<0>::KEY_TEXT, config);
+  }
+  {
+    sdsl::int_vector<> sa_vec(n, 0, width);
+    copy_values(sa, sa_vec, num_threads);
+    sdsl::store_to_cache(sa_vec, sdsl::conf::KEY_SA, config);
+  }
+  {
+    sdsl::int_vector<> lcp_vec(n, 0, width);
+    copy_values(lcp, lcp_vec, num_threads);
+    sdsl::store_to_cache(lcp_vec, sdsl::conf::KEY_LCP, config);
+  }
+}
+
+} // end namespace
@@ -0,0 +1,194 @@
+/**
+   degLPF: Computing Longest Previous Factor (LPF) Array in a Degenerate String
+   Copyright (C) 2018 Ritu Kundu, Fatima Vayani, and Steven Watts
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+/** Implements class Variant_sites
+ */
+#include "../include/Variant_sites.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+namespace deglpf {
+
+namespace {
+const UINT cVcf_fields = 5; // CHROM, POS, ID, REF and ALT
+const UINT cVcf_chunk_size = 1 << 16; // bytes decompressed at once
+} // end anonymous namespace
+
+ReturnStatus Variant_sites::read_vcf(const std::string &filename,
+                                     const Parser &parser) {
+  // Reads a gzip file or (transparently) an uncompressed one
+  gzFile file = gzopen(filename.c_str(), "rb");
+  if (file == nullptr) {
+    std::cerr << "Cannot open VCF file \n";
+    return ReturnStatus::ERR_FILE_OPEN;
+  }
+  ReturnStatus status = ReturnStatus::SUCCESS;
+  UINT line_number = 0;
+  std::string chrom;
+  std::vector<Variant_site> *chrom_sites = nullptr; // sites of chrom
+  auto process_line = [&](const char *begin, const char *end) {
+    ++line_number;
+    if (end > begin && *(end - 1) == '\r') {
+      --end;
+    }
+    if (begin == end || *begin == '#') {
+      return true; // header
+    }
+    // Start and end of the first fields (delimited by tabs)
+    const char *fields[cVcf_fields + 1];
+    fields[0] = begin;
+    for (UINT f = 1; f <= cVcf_fields; ++f) {
+      const char *tab = static_cast<const char *>(
+          std::memchr(fields[f - 1], '\t', end - fields[f - 1]));
+      if (tab == nullptr && f < cVcf_fields) {
+        std::cerr << "Invalid Input: VCF line " << line_number
+                  << " has less than " << cVcf_fields << " fields."
+                  << std::endl;
+        status = ReturnStatus::ERR_INVALID_INPUT;
+        return false;
+      }
+      fields[f] = (tab == nullptr) ? (end + 1) : (tab + 1);
+    }
+    if (chrom_sites == nullptr ||
+        chrom.compare(0, std::string::npos, fields[0],
+                      fields[1] - 1 - fields[0]) != 0) {
+      chrom.assign(fields[0], fields[1] - 1);
+      chrom_sites = &_sites[chrom];
+    }
+    if (!add_site(*chrom_sites, fields[1], fields[3], fields[4] - 1,
+                  fields[4], fields[5] - 1, parser)) {
+      std::cerr << "Invalid Input: VCF line " << line_number
+                << " has an invalid position." << std::endl;
+      status = ReturnStatus::ERR_INVALID_INPUT;
+      return false;
+    }
+    return true;
+  };
+
+  std::vector<char> buffer(cVcf_chunk_size);
+  std::string line; // a line over two chunks
+  int count;
+  bool valid = true;
+  while (valid && (count = gzread(file, buffer.data(), buffer.size())) > 0) {
+    const char *p = buffer.data();
+    const char *end = p + count;
+    while (valid) {
+      const char *nl =
+          static_cast<const char *>(std::memchr(p, '\n', end - p));
+      if (nl == nullptr) {
+        line.append(p, end);
+        break;
+      }
+      if (line.empty()) {
+        valid = process_line(p, nl);
+      } else {
+        line.append(p, nl);
+        valid = process_line(line.data(), line.data() + line.size());
+        line.clear();
+      }
+      p = nl + 1;
+    }
+  }
+  if (valid && count < 0) {
+    std::cerr << "Cannot read VCF file \n";
+    status = ReturnStatus::ERR_FILE_OPEN;
+  } else if (valid && !line.empty()) {
+    process_line(line.data(), line.data() + line.size()); // no newline
+  }
+  gzclose(file);
+
+  // In the order of the positions; the sites of one position are merged
+  for (auto &entry : _sites) {
+    auto &sites = entry.second;
+    std::stable_sort(sites.begin(), sites.end(),
+                     [](const Variant_site &a, const Variant_site &b) {
+                       return a.pos < b.pos;
+                     });
+    UINT last = 0;
+    for (UINT s = 1; s < sites.size(); ++s) {
+      if (sites[s].pos == sites[last].pos) {
+        sites[last].mask |= sites[s].mask;
+      } else {
+        sites[++last] = sites[s];
+      }
+    }
+    sites.resize(std::min<size_t>(sites.size(), last + 1));
+  }
+  return status;
+}
+
+const std::vector<Variant_site> *
+Variant_sites::get_sites(const std::string &chrom) const {
+  auto entry = _sites.find(chrom);
+  return (entry == _sites.end()) ? (nullptr) : (&entry->second);
+}
+
+const std::vector<Variant_site> *
+Variant_sites::get_sites_of_record(const std::string &name) const {
+  auto begin = std::find_if(name.begin(), name.end(),
+                            [](unsigned char c) { return !std::isspace(c); });
+  auto end = std::find_if(begin, name.end(),
+                          [](unsigned char c) { return std::isspace(c); });
+  return get_sites(std::string(begin, end));
+}
+
+UINT Variant_sites::get_numberof_sites() const {
+  UINT count = 0;
+  for (const auto &entry : _sites) {
+    count += entry.second.size();
+  }
+  return count;
+}
+
+//////////////////////// private ////////////////////////
+
+bool Variant_sites::add_site(std::vector<Variant_site> &sites,
+                             const char *pos, const char *ref,
+                             const char *ref_end, const char *alt,
+                             const char *alt_end, const Parser &parser) {
+  char *pos_end;
+  unsigned long position = std::strtoul(pos, &pos_end, 10);
+  if (pos_end == pos || position == 0) {
+    return false;
+  }
+  if (ref_end - ref != 1) {
+    return true; // not a SNP (e.g. an indel)
+  }
+  SYMBOL_MASK mask = parser.letter_mask(*ref);
+  SYMBOL_MASK alt_mask = 0;
+  // Alternative alleles delimited by commas
+  for (const char *allele = alt; allele < alt_end;) {
+    const char *comma = static_cast<const char *>(
+        std::memchr(allele, ',', alt_end - allele));
+    const char *allele_end = (comma == nullptr) ? (alt_end) : (comma);
+    if (allele_end - allele == 1) {
+      alt_mask |= parser.letter_mask(*allele); // 0 for '.' or '*'
+    }
+    allele = allele_end + 1;
+  }
+  if (mask == 0 || alt_mask == 0 ||
+      __builtin_popcount(mask | alt_mask) < 2) {
+    return true; // no SNP
+  }
+  sites.push_back(
+      Variant_site{static_cast<UINT>(position - 1), mask | alt_mask});
+  return true;
+}
+
+} // end namespace
@@ -16,17 +16,19 @@
 /** Module containing main() method.
  */
 
+#include <cstdio>
 #include <cstdlib>
 
-#include "../include/Degenerate_string.hpp"
+#include "../include/Gz_stream.hpp"
+#include "../include/Lpf_file.hpp"
+#include "../include/Mapped_file.hpp"
 #include "../include/Parser.hpp"
-#include "../include/Search.hpp"
+#include "../include/Pipeline.hpp"
+#include "../include/Variant_sites.hpp"
 #include "../include/globalDefs.hpp"
 #include "../include/utilDefs.hpp"
 
 using namespace deglpf;
-ReturnStatus calculate_lpf(const Parser &parser, const UINT alphabet_size,
-                           std::ifstream &infile, std::ofstream &outfile);
 
 int main(int argc, char **argv) {
 
@@ -36,20 +38,42 @@ int main(int argc, char **argv) {
     usage();
     return 1;
   }
-  /* Input file */
+  /* Conversion of a binary output file into the text format (the output is
+   * created once the input is known to be in the binary format) */
+  if (flags.convert_to_text) {
+    Lpf_reader reader;
+    ReturnStatus status = reader.open(flags.input_filename);
+    if (status != ReturnStatus::SUCCESS) {
+      return static_cast<int>(status);
+    }
+    std::string filename = flags.output_filename;
+    Gz_ostream outfile;
+    if (outfile.open(filename, Gz_ostream::is_compressed_name(filename)) !=
+        ReturnStatus::SUCCESS) {
+      std::cerr << "Cannot create output file \n";
+      return static_cast<int>(ReturnStatus::ERR_FILE_OPEN);
+    }
+    status = convert_to_text(reader, outfile);
+    if (status != ReturnStatus::SUCCESS) {
+      std::cerr << "Cannot convert input file \n";
+      outfile.close();
+      std::remove(filename.c_str()); // not left half converted
+      return static_cast<int>(status);
+    }
+    return static_cast<int>(outfile.close());
+  }
+  /* Input file: mapped in memory, or read as a stream decompressed on a
+   * helper thread (if it is compressed or cannot be mapped, e.g. a pipe) */
   std::string filename = flags.input_filename;
-  std::ifstream infile(filename);
-  if (!infile.is_open()) {
+  Mapped_file mapped_file;
+  bool is_mapped = mapped_file.open(filename) == ReturnStatus::SUCCESS &&
+                   !Gz_istream::is_compressed(mapped_file.begin(),
+                                              mapped_file.end());
+  Gz_istream infile; // reads an uncompressed stream as it is
+  if (!is_mapped && infile.open(filename) != ReturnStatus::SUCCESS) {
     std::cerr << "Cannot open input file \n";
     return static_cast<int>(ReturnStatus::ERR_FILE_OPEN);
   }
-  /* Output file */
-  filename = flags.output_filename;
-  std::ofstream outfile(filename);
-  if (!outfile.is_open()) {
-    std::cerr << "Cannot create output file \n";
-    return static_cast<int>(ReturnStatus::ERR_FILE_OPEN);
-  }
   /* Create Parser */
   std::string alphabet = cGENAlphabet;
   if (flags.alphabet_type == AlphabetType::DNA) {
@@ -59,87 +83,34 @@ int main(int argc, char **argv) {
   }
   Parser parser(flags.alphabet_type, alphabet);
 
-  /* Calculate and test result */
-  calculate_lpf(parser, alphabet.size(), infile, outfile);
-}
-
-ReturnStatus calculate_lpf(const Parser &parser, const UINT alphabet_size,
-                           std::ifstream &infile, std::ofstream &outfile) {
-  ReturnStatus status;
-  std::string line;
-  // Get the first sequence
-  std::getline(infile, line);
-  if (line.empty()) {
-    std::cerr << "No Input: Empty File: " << std::endl;
-    return ReturnStatus::ERR_INVALID_INPUT;
-  }
-  do {
-    std::string seq_name;
-    std::string seq_value;
-    if (!line.empty()) {
-      if (line[0] != '>') {
-        std::cerr
-            << "Invalid Input: Not a FASTA format: Expected '>' at line number"
-            << std::endl;
-        return ReturnStatus::ERR_INVALID_INPUT;
-      }
-      seq_name = line.substr(1);
-      std::cout << "Processing Sequence: " << seq_name << std::endl;
-      /* Encode the sequence */
-      Degenerate_string dgs(alphabet_size);
-      auto status = parser.parse_sequence(infile, dgs);
-      if (status != ReturnStatus::SUCCESS) {
-        std::cerr << "Invalid Input: Invalid sequence: " << seq_name
-                  << std::endl;
-        return status;
-      }
-      /* Calculate the LPF array and LPF-loc arrays for the sequence */
-      auto seq_size = dgs.get_size();
-      std::vector<UINT> lpf(seq_size, 0);
-      Search search(dgs);
-
-      std::clock_t startTime = clock();
-      search.calculate_lpf(lpf);
-      std::clock_t stopTime = clock();
-      double exec_time =
-          static_cast<double>(stopTime - startTime) / CLOCKS_PER_SEC;
-#ifdef DEBUG
-      // PRINTING FOR DEBUGGING
-      std::cout << "LPF ARRAY: \n";
-      for (UINT c : lpf) {
-        std::cout << c << " ";
-      }
-      std::cout << "\n";
-#endif
-/**
-      /* Test result 
-      // The function assumes that the pre-processing has been done.
-      if (!search.naive_test(lpf)) {
-        std::cerr << "INCORRECT RESULT FOR THE SEQUENCE: " << seq_name
-                  << std::endl;
-        break;
-      }
-
-**/
-      /* Print result */
-      // First line of a block: > followed by the sequence name
-      outfile << ">" << seq_name << std::endl;
-      // Next line of the block: Execution time (in sec)
-      outfile << exec_time << std::endl;
-      // Next line: values of sequence size and number of degenerate symbols
-      // (deleimited by a space)
-      outfile << seq_size << " " << dgs.get_numberof_seeds() - 1 << std::endl;
-      // Next line: lpf array : each cell deleimited by a space
-      for (auto l : lpf) {
-        outfile << l << " ";
-      }
-      outfile << std::endl;
-      // The block ends with an empty line to delimit it from the following
-      // block
-      outfile << std::endl;
+  /* Variants of the (reference) sequences */
+  Variant_sites variant_sites;
+  if (!flags.vcf_filename.empty()) {
+    ReturnStatus status = variant_sites.read_vcf(flags.vcf_filename, parser);
+    if (status != ReturnStatus::SUCCESS) {
+      return static_cast<int>(status);
     }
-  } while (std::getline(infile, line)); // sequence ends
+    std::cout << "Variant sites read: " << variant_sites.get_numberof_sites()
+              << std::endl;
+  }
 
-  std::cout << "LPF calculated successfully: " << std::endl;
-  return ReturnStatus::SUCCESS;
-}
\ No newline at end of file
+  /* Output file: written on a helper thread, compressed (BGZF) if its name
+   * ends in .gz */
+  filename = flags.output_filename;
+  Gz_ostream outfile;
+  if (outfile.open(filename, Gz_ostream::is_compressed_name(filename)) !=
+      ReturnStatus::SUCCESS) {
+    std::cerr << "Cannot create output file \n";
+    return static_cast<int>(ReturnStatus::ERR_FILE_OPEN);
+  }
+  /* Calculate the LPF-arrays of the records (a few at a time) */
+  Pipeline pipeline(parser, alphabet.size(), flags.search_options,
+                    flags.pipeline_options,
+                    flags.vcf_filename.empty() ? nullptr : &variant_sites);
+  if (is_mapped) {
+    pipeline.run(mapped_file.begin(), mapped_file.end(), outfile);
+  } else {
+    pipeline.run(infile, outfile);
+  }
+  return static_cast<int>(outfile.close());
+}
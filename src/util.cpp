@@ -15,6 +15,7 @@
 
 /** Implemets the utility functions defined in utilDefs.hpp */
 
+#include "../include/Gz_stream.hpp"
 #include "../include/utilDefs.hpp"
 
 namespace deglpf {
@@ -23,6 +24,20 @@ static struct option long_options[] = {
     {"alphabet", required_argument, NULL, 'a'},
     {"input-file", required_argument, NULL, 'i'},
     {"output-file", required_argument, NULL, 'o'},
+    {"threads", required_argument, NULL, 't'},
+    {"fill", required_argument, NULL, 'f'},
+    {"layout", required_argument, NULL, 'l'},
+    {"index", required_argument, NULL, 'x'},
+    {"backward", required_argument, NULL, 'b'},
+    {"candidates", required_argument, NULL, 'c'},
+    {"stats", no_argument, NULL, 's'},
+    {"records", required_argument, NULL, 'r'},
+    {"in-flight", required_argument, NULL, 'm'},
+    {"group", required_argument, NULL, 'g'},
+    {"build-threads", required_argument, NULL, 'p'},
+    {"vcf", required_argument, NULL, 'v'},
+    {"format", required_argument, NULL, 'F'},
+    {"to-text", no_argument, NULL, 'T'},
     {"help", no_argument, NULL, 'h'},
     {NULL, 0, NULL, 0}};
 
@@ -31,9 +46,10 @@ static struct option long_options[] = {
 ReturnStatus decodeFlags(int argc, char *argv[], struct InputFlags &flags) {
   int args = 0;
   int opt;
+  int num;
   std::string alph;
   /* initialisation */
-  while ((opt = getopt_long(argc, argv, "a:i:o:h", long_options, nullptr)) !=
+  while ((opt = getopt_long(argc, argv, "a:i:o:t:f:l:x:b:c:sr:m:g:p:v:F:Th", long_options, nullptr)) !=
          -1) {
     switch (opt) {
     case 'a':
@@ -61,10 +77,159 @@ ReturnStatus decodeFlags(int argc, char *argv[], struct InputFlags &flags) {
       args++;
       break;
 
+    case 't':
+      num = std::atoi(optarg);
+      if (num < 1) {
+        std::cerr << "Invalid command: number of threads should be positive: "
+                  << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      flags.search_options.num_threads = num;
+      break;
+
+    case 'f':
+      if (std::string(optarg) == "rows") {
+        flags.search_options.fill_type = FillType::ROWS;
+      } else if (std::string(optarg) == "diagonals") {
+        flags.search_options.fill_type = FillType::DIAGONALS;
+      } else if (std::string(optarg) == "lazy") {
+        flags.search_options.fill_type = FillType::LAZY;
+      } else {
+        std::cerr << "Invalid command: wrong fill type: " << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      break;
+
+    case 'l':
+      if (std::string(optarg) == "symbol") {
+        flags.search_options.table_layout = TableLayout::SYMBOL_MAJOR;
+      } else if (std::string(optarg) == "position") {
+        flags.search_options.table_layout = TableLayout::POSITION_MAJOR;
+      } else {
+        std::cerr << "Invalid command: wrong table layout: " << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      break;
+
+    case 'x':
+      if (std::string(optarg) == "succinct") {
+        flags.search_options.index_profile = IndexProfile::SUCCINCT;
+      } else if (std::string(optarg) == "fast") {
+        flags.search_options.index_profile = IndexProfile::FAST;
+      } else if (std::string(optarg) == "compact") {
+        flags.search_options.index_profile = IndexProfile::COMPACT;
+      } else {
+        std::cerr << "Invalid command: wrong index profile: " << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      break;
+
+    case 'b':
+      if (std::string(optarg) == "index") {
+        flags.search_options.backward_lce = BackwardLce::REVERSE_INDEX;
+      } else if (std::string(optarg) == "zarray") {
+        flags.search_options.backward_lce = BackwardLce::Z_ARRAY;
+      } else {
+        std::cerr << "Invalid command: wrong backward extension: " << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      break;
+
+    case 'c':
+      if (std::string(optarg) == "scan") {
+        flags.search_options.l_region_search = LRegionSearch::SCAN;
+      } else if (std::string(optarg) == "borders") {
+        flags.search_options.l_region_search = LRegionSearch::BORDERS;
+      } else {
+        std::cerr << "Invalid command: wrong candidate search: " << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      break;
+
+    case 's':
+      flags.pipeline_options.print_stats = true;
+      break;
+
+    case 'r':
+      num = std::atoi(optarg);
+      if (num < 1) {
+        std::cerr << "Invalid command: number of records should be positive: "
+                  << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      flags.pipeline_options.num_workers = num;
+      break;
+
+    case 'm':
+      num = std::atoi(optarg);
+      if (num < 1) {
+        std::cerr << "Invalid command: number of records in flight should be "
+                     "positive: "
+                  << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      flags.pipeline_options.max_in_flight = num;
+      break;
+
+    case 'g':
+      num = std::atoi(optarg);
+      if (num < 1) {
+        std::cerr << "Invalid command: size of a group should be positive: "
+                  << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      flags.pipeline_options.group_size = num;
+      break;
+
+    case 'p':
+      num = std::atoi(optarg);
+      if (num < 1) {
+        std::cerr << "Invalid command: number of threads building the index "
+                     "should be positive: "
+                  << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      flags.search_options.build_threads = num;
+      break;
+
+    case 'v':
+      flags.vcf_filename = std::string(optarg);
+      break;
+
+    case 'F':
+      if (std::string(optarg) == "text") {
+        flags.pipeline_options.output_format = OutputFormat::TEXT;
+      } else if (std::string(optarg) == "binary") {
+        flags.pipeline_options.output_format = OutputFormat::BINARY;
+      } else if (std::string(optarg) == "irreducible") {
+        flags.pipeline_options.output_format = OutputFormat::IRREDUCIBLE;
+      } else {
+        std::cerr << "Invalid command: wrong output format: " << std::endl;
+        return (ReturnStatus::ERR_ARGS);
+      }
+      break;
+
+    case 'T':
+      flags.convert_to_text = true;
+      break;
+
     case 'h':
       return (ReturnStatus::HELP);
     }
   }
+  // A binary output is to be mapped in memory; so it is not compressed
+  if (flags.pipeline_options.output_format != OutputFormat::TEXT &&
+      !flags.convert_to_text &&
+      Gz_ostream::is_compressed_name(flags.output_filename)) {
+    std::cerr << "Invalid command: a binary output file cannot be compressed "
+                 "(.gz): "
+              << std::endl;
+    return (ReturnStatus::ERR_ARGS);
+  }
+  if (flags.convert_to_text && !flags.input_filename.empty() &&
+      !flags.output_filename.empty()) {
+    return (ReturnStatus::SUCCESS); // no alphabet is needed
+  }
   if (args < 3) {
     std::cerr << "Invalid command: Too few arguments: " << std::endl;
     return (ReturnStatus::ERR_ARGS);
@@ -85,6 +250,47 @@ void usage(void) {
   std::cout << "  -i, --input-file \t <str> \t \t Input file  name for "
                "sequences (FASTA format currently).\n";
   std::cout << "  -o, --output-file \t <str> \t \t Output filename.\n";
+  std::cout << " Optional:\n";
+  std::cout << "  -t, --threads \t <int> \t \t Number of threads used for "
+               "calculating the LPF-array (default: 1).\n";
+  std::cout << "  -f, --fill \t \t <str> \t \t `rows', `diagonals' "
+               "(concurrent) or `lazy' (on demand) filling of the table of "
+               "degenerate matches (default: rows).\n";
+  std::cout << "  -l, --layout \t \t <str> \t \t `symbol' or `position' "
+               "(major) layout of the table of degenerate matches (default: "
+               "symbol).\n";
+  std::cout << "  -x, --index \t \t <str> \t \t `succinct', `fast' (more "
+               "memory) or `compact' (less memory) index for the LCP queries "
+               "(default: succinct).\n";
+  std::cout << "  -b, --backward \t <str> \t \t `index' (of the reverse "
+               "sequence) or `zarray' (per block; no reverse index) for the "
+               "backward extensions of Type 2 search (default: index).\n";
+  std::cout << "  -c, --candidates \t <str> \t \t `scan' (LCP queries) or "
+               "`borders' (KMP pass per seed) search for the candidates of "
+               "Type 1 search in the L-regions (default: scan).\n";
+  std::cout << "  -s, --stats \t \t \t \t Print the statistics of the "
+               "chains of degenerate matches of each sequence.\n";
+  std::cout << "  -r, --records \t <int> \t \t Number of sequences (or "
+               "groups) processed concurrently (default: 1).\n";
+  std::cout << "  -m, --in-flight \t <int> \t \t Maximum number of "
+               "sequences read but not yet written (default: twice the "
+               "sequences processed concurrently).\n";
+  std::cout << "  -g, --group \t \t <int> \t \t Number of consecutive "
+               "sequences sharing one index (default: 1, i.e. an index per "
+               "sequence).\n";
+  std::cout << "  -p, --build-threads \t <int> \t \t Number of threads "
+               "building the index of each sequence (or group), shared by the "
+               "forward and reverse indexes (default: 1).\n";
+  std::cout << "  -v, --vcf \t \t <str> \t \t VCF file (uncompressed or "
+               "gzip) of the SNPs of the input (reference) sequences; the "
+               "letter at each site becomes a degenerate symbol.\n";
+  std::cout << "  -F, --format \t \t <str> \t \t `text', `binary' "
+               "(bit-packed, to be mapped in memory) or `irreducible' (binary, "
+               "each array stored by the positions where it is not the "
+               "previous value minus 1) format of the output file (default: "
+               "text).\n";
+  std::cout << "  -T, --to-text \t \t \t Convert the input (a binary output "
+               "file) into the text format (-a is not needed).\n";
 }
 
 } // end namespace
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "Gz_stream.hpp"
+#include "globalDefs.hpp"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace deglpf;
+
+// Lines of numbers, as the output of the tool (over several chunks)
+std::string sample_text(const UINT lines) {
+  std::ostringstream text;
+  for (UINT i = 0; i < lines; ++i) {
+    text << "> seq " << i << "\n";
+    for (UINT j = 0; j < 50; ++j) {
+      text << (i * 31 + j * 7) % 1000 << " ";
+    }
+    text << "\n\n";
+  }
+  return text.str();
+}
+
+std::string read_file(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+TEST(gzStreamTest, BgzfOutput) {
+  const std::string filename = "gz_stream_test.txt.gz";
+  const std::string text = sample_text(20000);
+  EXPECT_TRUE(Gz_ostream::is_compressed_name(filename));
+  EXPECT_FALSE(Gz_ostream::is_compressed_name("output.txt"));
+  {
+    Gz_ostream outfile;
+    ASSERT_EQ(ReturnStatus::SUCCESS, outfile.open(filename));
+    // Both single characters and blocks
+    outfile << text.substr(0, 100);
+    for (UINT i = 100; i < 1000; ++i) {
+      outfile.put(text[i]);
+    }
+    outfile.flush();
+    outfile << text.substr(1000);
+    EXPECT_EQ(ReturnStatus::SUCCESS, outfile.close());
+  }
+  std::string compressed = read_file(filename);
+  ASSERT_GT(compressed.size(), 28);
+  EXPECT_LT(compressed.size(), text.size() / 2);
+  // BGZF: the extra field "BC" in each block, the empty block at the end
+  EXPECT_EQ(std::string("\x1f\x8b\x08\x04", 4), compressed.substr(0, 4));
+  EXPECT_EQ("BC", compressed.substr(12, 2));
+  EXPECT_EQ(std::string("\x1b\x00\x03\x00", 4),
+            compressed.substr(compressed.size() - 12, 4));
+  EXPECT_TRUE(Gz_istream::is_compressed(compressed.data(),
+                                        compressed.data() + compressed.size()));
+  // Readable by zlib as gzip
+  gzFile file = gzopen(filename.c_str(), "rb");
+  std::string decompressed(text.size() + 1, '\0');
+  int count = gzread(file, &decompressed[0], decompressed.size());
+  gzclose(file);
+  ASSERT_EQ(text.size(), count);
+  decompressed.resize(count);
+  EXPECT_EQ(text, decompressed);
+
+  // Read back through the helper thread
+  Gz_istream infile;
+  ASSERT_EQ(ReturnStatus::SUCCESS, infile.open(filename));
+  std::string read((std::istreambuf_iterator<char>(infile)),
+                   std::istreambuf_iterator<char>());
+  EXPECT_EQ(text, read);
+  std::remove(filename.c_str());
+}
+
+TEST(gzStreamTest, IncompressibleOutput) {
+  const std::string filename = "gz_stream_test_random.gz";
+  // Pseudo-random bytes: each block is deflated no smaller than its data
+  std::string data(300000, '\0');
+  uint32_t state = 12345;
+  for (auto &c : data) {
+    state = state * 1103515245u + 12345u;
+    c = static_cast<char>(state >> 24);
+  }
+  {
+    Gz_ostream outfile;
+    ASSERT_EQ(ReturnStatus::SUCCESS, outfile.open(filename));
+    outfile << data;
+    EXPECT_EQ(ReturnStatus::SUCCESS, outfile.close());
+  }
+  gzFile file = gzopen(filename.c_str(), "rb");
+  std::string decompressed(data.size() + 1, '\0');
+  int count = gzread(file, &decompressed[0], decompressed.size());
+  gzclose(file);
+  ASSERT_EQ(static_cast<int>(data.size()), count);
+  decompressed.resize(count);
+  EXPECT_EQ(data, decompressed);
+  std::remove(filename.c_str());
+}
+
+TEST(gzStreamTest, UncompressedOutput) {
+  const std::string filename = "gz_stream_test_plain.txt";
+  const std::string text = sample_text(20000);
+  {
+    Gz_ostream outfile;
+    ASSERT_EQ(ReturnStatus::SUCCESS, outfile.open(filename, false));
+    outfile << text.substr(0, 100);
+    for (UINT i = 100; i < 1000; ++i) {
+      outfile.put(text[i]);
+    }
+    outfile.flush();
+    outfile << text.substr(1000);
+    EXPECT_EQ(ReturnStatus::SUCCESS, outfile.close());
+  }
+  EXPECT_EQ(text, read_file(filename));
+  std::remove(filename.c_str());
+}
+
+TEST(gzStreamTest, GzipInput) {
+  const std::string filename = "gz_stream_test.txt";
+  const std::string text = sample_text(5000);
+  // Two gzip members, then an uncompressed file
+  {
+    gzFile file = gzopen(filename.c_str(), "wb");
+    gzwrite(file, text.data(), 1000);
+    gzclose(file);
+    file = gzopen(filename.c_str(), "ab");
+    gzwrite(file, text.data() + 1000, text.size() - 1000);
+    gzclose(file);
+  }
+  for (bool compressed : {true, false}) {
+    Gz_istream infile;
+    ASSERT_EQ(ReturnStatus::SUCCESS, infile.open(filename));
+    std::string line;
+    std::string read;
+    while (std::getline(infile, line)) {
+      read += line + "\n";
+    }
+    EXPECT_EQ(text, read) << compressed;
+    std::ofstream file(filename);
+    file << text;
+  }
+  // Stops early: the helper is not left waiting
+  {
+    Gz_istream infile;
+    ASSERT_EQ(ReturnStatus::SUCCESS, infile.open(filename));
+    std::string line;
+    std::getline(infile, line);
+    EXPECT_EQ("> seq 0", line);
+  }
+  std::remove(filename.c_str());
+  EXPECT_EQ(ReturnStatus::ERR_FILE_OPEN, Gz_istream().open(filename));
+}
@@ -0,0 +1,86 @@
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Irreducible_lpf.hpp"
+#include "globalDefs.hpp"
+#include "gtest/gtest.h"
+
+using namespace deglpf;
+
+// Checks the random access, the decoding and the serialization of the array
+void expect_same_lpf(const std::vector<UINT> &expected) {
+  Irreducible_lpf lpf(expected);
+  ASSERT_EQ(expected.size(), lpf.size());
+  for (UINT i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], lpf[i]);
+  }
+  std::vector<UINT> decoded;
+  lpf.get_lpf(decoded);
+  EXPECT_EQ(expected, decoded);
+
+  std::ostringstream out;
+  uint64_t num_bytes = lpf.serialize(out);
+  std::string data = out.str();
+  ASSERT_EQ(num_bytes, data.size());
+  Irreducible_lpf loaded;
+  ASSERT_EQ(ReturnStatus::SUCCESS,
+            loaded.load(data.data(), data.data() + data.size()));
+  EXPECT_EQ(lpf.get_numberof_irreducible(), loaded.get_numberof_irreducible());
+  loaded.get_lpf(decoded);
+  EXPECT_EQ(expected, decoded);
+  // A copy has its own rank and select structures
+  Irreducible_lpf copy(loaded);
+  loaded = Irreducible_lpf();
+  copy.get_lpf(decoded);
+  EXPECT_EQ(expected, decoded);
+  // So has a moved array; the moved one is left empty
+  Irreducible_lpf moved(std::move(copy));
+  EXPECT_EQ(0u, copy.size());
+  loaded = std::move(moved);
+  EXPECT_EQ(0u, moved.size());
+  ASSERT_EQ(expected.size(), loaded.size());
+  for (UINT i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], loaded[i]);
+  }
+}
+
+TEST(irreducibleLpfTest, Positions) {
+  std::vector<UINT> lpf = {0, 0, 4, 3, 2, 1, 0, 2, 3, 2, 1};
+  Irreducible_lpf irreducible_lpf(lpf);
+  // 0, 1, 2, 7 and 8; then the runs go down by one
+  EXPECT_EQ(5u, irreducible_lpf.get_numberof_irreducible());
+  EXPECT_EQ(4u, irreducible_lpf.get_irreducible_value(2));
+  EXPECT_EQ(3u, irreducible_lpf.get_irreducible_value(4));
+  expect_same_lpf(lpf);
+}
+
+TEST(irreducibleLpfTest, Arrays) {
+  expect_same_lpf({});
+  expect_same_lpf({0});
+  expect_same_lpf({0, 0, 0, 0});
+  // Long runs and irregular values
+  std::vector<UINT> lpf;
+  for (UINT r = 0; r < 300; ++r) {
+    UINT l = (r * 7919) % 1000;
+    for (UINT i = 0; i < r % 13 && l > 0; ++i) {
+      lpf.push_back(l--);
+    }
+    lpf.push_back((r * 31) % 5);
+  }
+  expect_same_lpf(lpf);
+}
+
+TEST(irreducibleLpfTest, InvalidData) {
+  Irreducible_lpf lpf(std::vector<UINT>{0, 5, 4, 3, 9, 8});
+  std::ostringstream out;
+  lpf.serialize(out);
+  std::string data = out.str();
+  Irreducible_lpf loaded;
+  EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT,
+            loaded.load(data.data(), data.data() + data.size() - 8));
+  EXPECT_EQ(0u, loaded.size());
+  data += "extra";
+  EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT,
+            loaded.load(data.data(), data.data() + data.size()));
+}
@@ -0,0 +1,152 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Lpf_file.hpp"
+#include "Parser.hpp"
+#include "Pipeline.hpp"
+#include "globalDefs.hpp"
+#include "gtest/gtest.h"
+
+using namespace deglpf;
+
+// Writes the given data to a file of the given name
+void write_lpf_file(const std::string &filename, const std::string &data) {
+  std::ofstream file(filename, std::ios::binary);
+  file << data;
+}
+
+TEST(lpfFileTest, ReadsRecordsInPlace) {
+  const std::string filename = "lpf_file_test.bin";
+  // Values needing various widths; an array of zeros; an empty name
+  std::vector<std::vector<UINT>> arrays = {
+      {0, 3, 2, 1, 0, 7, 6, 5}, {0, 0, 0}, {}, {1000000, 1, 0}};
+  for (UINT i = 0; i < 200; ++i) {
+    arrays[0].push_back((i * 37) % 129);
+  }
+  std::vector<std::string> names = {"seq 1", "", "empty", "a longer name"};
+  std::ostringstream binary;
+  std::string text;
+  binary.write(cLpf_file_magic, sizeof(cLpf_file_magic));
+  // Both kinds of records, in turn
+  for (UINT r = 0; r < arrays.size(); ++r) {
+    if (r % 2 == 0) {
+      write_binary_record(binary, names[r], 0.25 * r, r, arrays[r]);
+    } else {
+      write_irreducible_record(binary, names[r], 0.25 * r, r,
+                               Irreducible_lpf(arrays[r]));
+    }
+    write_text_record(text, names[r], 0.25 * r, r, arrays[r]);
+  }
+  write_lpf_file(filename, binary.str());
+
+  Lpf_reader reader;
+  ASSERT_EQ(ReturnStatus::SUCCESS, reader.open(filename));
+  Lpf_record record;
+  for (UINT r = 0; r < arrays.size(); ++r) {
+    ASSERT_EQ(ReturnStatus::SUCCESS, reader.next(record));
+    EXPECT_EQ(names[r], record.name);
+    EXPECT_EQ(arrays[r].size(), record.size);
+    EXPECT_EQ(r, record.num_symbols);
+    EXPECT_EQ(0.25 * r, record.exec_time);
+    EXPECT_EQ(r % 2 == 1, record.is_irreducible);
+    for (UINT i = 0; i < arrays[r].size(); ++i) {
+      EXPECT_EQ(arrays[r][i], record[i]);
+    }
+    std::vector<UINT> lpf;
+    record.get_lpf(lpf);
+    EXPECT_EQ(arrays[r], lpf);
+  }
+  EXPECT_EQ(ReturnStatus::ERR_LIMIT_EXCEEDS, reader.next(record));
+
+  // The conversion gives the text format
+  std::ostringstream converted;
+  EXPECT_EQ(ReturnStatus::SUCCESS, convert_to_text(filename, converted));
+  EXPECT_EQ(text, converted.str());
+
+  // A truncated record is invalid
+  write_lpf_file(filename, binary.str().substr(0, binary.str().size() - 8));
+  ASSERT_EQ(ReturnStatus::SUCCESS, reader.open(filename));
+  for (UINT r = 0; r + 1 < arrays.size(); ++r) {
+    EXPECT_EQ(ReturnStatus::SUCCESS, reader.next(record));
+  }
+  EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT, reader.next(record));
+
+  // A file of another format is rejected
+  write_lpf_file(filename, text);
+  EXPECT_NE(ReturnStatus::SUCCESS, reader.open(filename));
+  std::remove(filename.c_str());
+}
+
+TEST(lpfFileTest, TextFormatting) {
+  // Values of every number of digits, over several chunks of values
+  std::vector<UINT> lpf = {0, 9, 10, 99, 100, 4294967295u, 1000000000};
+  for (UINT i = 0; i < 300000; ++i) {
+    lpf.push_back((i * 2654435761u) >> (i % 32));
+  }
+  std::ostringstream expected;
+  expected << ">seq\n" << 0.5 << "\n" << lpf.size() << " " << 3 << "\n";
+  for (auto l : lpf) {
+    expected << l << " ";
+  }
+  expected << "\n\n";
+  for (UINT num_threads : {1, 4}) {
+    std::string text;
+    write_text_record(text, "seq", 0.5, 3, lpf, num_threads);
+    EXPECT_EQ(expected.str(), text);
+  }
+  // A block is appended to the text
+  std::string text = "previous\n";
+  write_text_record(text, "empty", 0.5, 0, std::vector<UINT>());
+  EXPECT_EQ("previous\n>empty\n0.5\n0 0\n\n\n", text);
+}
+
+// Text outputs equal but for the lines of the execution times
+void expect_same_text(const std::string &expected,
+                      const std::string &converted) {
+  std::istringstream expected_lines(expected);
+  std::istringstream converted_lines(converted);
+  std::string expected_line;
+  std::string converted_line;
+  bool time_line = false;
+  UINT num_lines = 0;
+  while (std::getline(expected_lines, expected_line)) {
+    ASSERT_TRUE(static_cast<bool>(std::getline(converted_lines, converted_line)));
+    if (!time_line) {
+      EXPECT_EQ(expected_line, converted_line);
+    }
+    time_line = (!expected_line.empty() && expected_line[0] == '>');
+    ++num_lines;
+  }
+  EXPECT_FALSE(static_cast<bool>(std::getline(converted_lines, converted_line)));
+  EXPECT_EQ(15u, num_lines); // 5 lines per record
+}
+
+TEST(lpfFileTest, BinaryPipelineOutput) {
+  const std::string filename = "lpf_pipeline_test.bin";
+  std::string input =
+      ">a\nACGTACGTAC{A G}TACG\n\n>b\nGGGG\n\n>c\nAC{C T}ACCACT\n";
+  std::string alphabet = "ACGTU";
+  Parser parser(AlphabetType::DNA, alphabet);
+  PipelineOptions options;
+  Pipeline text_pipeline(parser, alphabet.size(), SearchOptions(), options);
+  std::ostringstream text;
+  ASSERT_EQ(ReturnStatus::SUCCESS,
+            text_pipeline.run(input.data(), input.data() + input.size(), text));
+  for (auto format : {OutputFormat::BINARY, OutputFormat::IRREDUCIBLE}) {
+    options.output_format = format;
+    options.num_workers = 2;
+    Pipeline binary_pipeline(parser, alphabet.size(), SearchOptions(), options);
+    {
+      std::ofstream binary(filename, std::ios::binary);
+      ASSERT_EQ(ReturnStatus::SUCCESS,
+                binary_pipeline.run(input.data(), input.data() + input.size(),
+                                    binary));
+    }
+    std::ostringstream converted;
+    ASSERT_EQ(ReturnStatus::SUCCESS, convert_to_text(filename, converted));
+    std::remove(filename.c_str());
+    expect_same_text(text.str(), converted.str());
+  }
+}
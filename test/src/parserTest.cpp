@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <sstream>
 
 using namespace deglpf;
 
@@ -14,7 +15,7 @@ TEST(parserTest, VariousDegeneratePatterns) {
   
   std::ifstream infile("test_files/testParser.txt");
 
-  std::vector<SEEDS> s = {{{1, 1, 2}, {3, 3},  {},  {4, 1},},
+  std::vector<std::vector<SEED>> s = {{{1, 1, 2}, {3, 3},  {},  {4, 1},},
   {{},{},{},{}},
    {{1, 1, 2, 3}},
    {{},{},{1, 1, 2}},
@@ -23,7 +24,7 @@ TEST(parserTest, VariousDegeneratePatterns) {
     {{},{},{1, 1, 2},{},{}}
     };
 
-  std::vector<DEGENERATE_SYMBOLS> ds = {
+  std::vector<std::vector<std::vector<bool>>> ds = {
       {{false, true, false, true, false, false},
        {false,true, true, false, false, false},
        {false,true, true, true, true, false}},
@@ -67,21 +68,154 @@ std::string alphabet = "ACGTU";
 
   for (int i = 0; i < dgs.size(); ++i) {
     Degenerate_string &dstr = dgs[i];
-    const SEEDS &seeds = dstr.get_seeds();
-    assert(s[i].size() == seeds.size());
-    for (int j = 0; j < seeds.size(); ++j) {
-      for (int k = 0; k < seeds[j].size(); ++k) {
-        EXPECT_EQ(s[i][j][k], seeds[j][k]);
+    const std::vector<ENCODED_CHAR> &symbols = dstr.get_symbols();
+    const std::vector<UINT> &offsets = dstr.get_seed_offsets();
+    assert(s[i].size() == offsets.size());
+    for (int j = 0; j < offsets.size(); ++j) {
+      for (int k = 0; k < s[i][j].size(); ++k) {
+        EXPECT_EQ(s[i][j][k], symbols[offsets[j] + k]);
       }
     }
-    const DEGENERATE_SYMBOLS &symb = dstr.get_degenerate_symbols();
     const std::vector<UINT> &indices = dstr.get_degenerate_indices();
-    for (int j = 0; j < seeds.size() - 1; ++j) {
+    for (int j = 0; j < offsets.size() - 1; ++j) {
       for (int k = 0; k < alphabet.size()+1; ++k) {
-        EXPECT_EQ(ds[i][j][k], symb[j][k]);
+        EXPECT_EQ(ds[i][j][k], dstr.has_letter(j, k));
       }
       EXPECT_EQ(ind[i][j], indices[j]);
+      EXPECT_TRUE(dstr.is_degenerate(indices[j]));
+      EXPECT_EQ(j, dstr.get_symbol_index(indices[j]));
     }
   }
 }
 
+
+TEST(parserTest, WideAlphabetMasks) {
+  // Letters beyond the first mask word
+  Degenerate_string dstr(40);
+  dstr.add_seed(SEED{});
+  dstr.add_degenerate_symbol(std::vector<ENCODED_CHAR>{1, 35});
+  dstr.add_seed(SEED{35});
+  dstr.add_degenerate_symbol(std::vector<ENCODED_CHAR>{2, 35, 40});
+  dstr.add_seed(SEED{});
+  dstr.add_degenerate_symbol(std::vector<ENCODED_CHAR>{2, 40});
+  dstr.add_seed(SEED{});
+  EXPECT_EQ(2, dstr.get_mask_words());
+  EXPECT_TRUE(dstr.has_letter(0, 35));
+  EXPECT_FALSE(dstr.has_letter(0, 34));
+  EXPECT_TRUE(dstr.has_letter(1, 40));
+  // Positions: symbol 0 (0), seed letter (1), symbol 1 (2), symbol 2 (3)
+  EXPECT_TRUE(dstr.is_match(0, 1));
+  EXPECT_TRUE(dstr.is_match(0, 2));
+  EXPECT_FALSE(dstr.is_match(0, 3));
+  EXPECT_TRUE(dstr.is_match(2, 3));
+  EXPECT_FALSE(dstr.is_match(1, 3));
+}
+
+TEST(parserTest, InMemory) {
+  // Runs of letters longer than a block of 16, split by spaces and newlines
+  std::string body;
+  for (UINT i = 0; i < 300; ++i) {
+    body += "acgtACGTu"[i * 7 % 9];
+    if (i % 37 == 36) {
+      body += "\n";
+    } else if (i % 23 == 22) {
+      body += " \t";
+    } else if (i % 50 == 49) {
+      body += "{A c\nG}";
+    }
+  }
+  body += "\n";
+  std::string alphabet = "ACGTU";
+  Parser parser(AlphabetType::DNA, alphabet);
+  Degenerate_string expected(alphabet.size());
+  std::istringstream infile(body);
+  ASSERT_EQ(ReturnStatus::SUCCESS, parser.parse_sequence(infile, expected));
+  Degenerate_string dstr(alphabet.size());
+  ASSERT_EQ(ReturnStatus::SUCCESS,
+            parser.parse_sequence(body.data(), body.data() + body.size(), dstr));
+  EXPECT_EQ(300 + 6, dstr.get_size());
+  EXPECT_EQ(expected.get_symbols(), dstr.get_symbols());
+  EXPECT_EQ(expected.get_seed_offsets(), dstr.get_seed_offsets());
+  EXPECT_EQ(expected.get_degenerate_indices(), dstr.get_degenerate_indices());
+  EXPECT_EQ(expected.get_degenerate_symbols(), dstr.get_degenerate_symbols());
+
+  // Invalid characters within a run, in a symbol, and beyond ASCII
+  for (std::string invalid :
+       {"ACGTACGTACGTACGTACGTEACGT", "AC{AE}", "ACG\xC3\x89T", "AC{A{C}G}",
+        "AC{A}", "AC{AC", "  \n"}) {
+    Degenerate_string bad(alphabet.size());
+    EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT,
+              parser.parse_sequence(invalid.data(),
+                                    invalid.data() + invalid.size(), bad))
+        << invalid;
+  }
+}
+
+TEST(parserTest, GeneralAlphabet) {
+  std::string alphabet = cGENAlphabet;
+  Parser parser(AlphabetType::GEN, alphabet);
+  std::string body = "AZ{BY}\nQ";
+  Degenerate_string dstr(alphabet.size());
+  ASSERT_EQ(ReturnStatus::SUCCESS,
+            parser.parse_sequence(body.data(), body.data() + body.size(), dstr));
+  EXPECT_EQ((std::vector<ENCODED_CHAR>{1, 26, cDegenerate_marker, 17}),
+            dstr.get_symbols());
+  EXPECT_TRUE(dstr.has_letter(0, 2));
+  EXPECT_TRUE(dstr.has_letter(0, 25));
+  // Lower case is not in the general alphabet
+  std::string lower = "Az";
+  EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT,
+            parser.parse_sequence(lower.data(), lower.data() + lower.size(),
+                                  dstr));
+}
+
+// Parses the two bodies and expects the same degenerate strings
+void expect_same_parse(const Parser &parser, const UINT alphabet_size,
+                       const std::string &body, const std::string &expanded) {
+  Degenerate_string dstr(alphabet_size);
+  Degenerate_string expected(alphabet_size);
+  ASSERT_EQ(ReturnStatus::SUCCESS,
+            parser.parse_sequence(body.data(), body.data() + body.size(), dstr))
+      << body;
+  ASSERT_EQ(ReturnStatus::SUCCESS,
+            parser.parse_sequence(expanded.data(),
+                                  expanded.data() + expanded.size(), expected));
+  EXPECT_EQ(expected.get_symbols(), dstr.get_symbols()) << body;
+  EXPECT_EQ(expected.get_seed_offsets(), dstr.get_seed_offsets()) << body;
+  EXPECT_EQ(expected.get_degenerate_indices(), dstr.get_degenerate_indices());
+  EXPECT_EQ(expected.get_degenerate_symbols(), dstr.get_degenerate_symbols());
+}
+
+TEST(parserTest, AmbiguityCodes) {
+  Parser dna_parser(AlphabetType::DNA, cDNAAlphabet);
+  expect_same_parse(dna_parser, cDNAAlphabet.size(), "NACNRg\nkm{AN}y SWBDHV",
+                    "{ACGT}AC{ACGT}{AG}G{GT}{AC}{ACGT}{CT}{CG}{AT}{CGT}{AGT}"
+                    "{ACT}{ACG}");
+  // Runs of codes and of letters longer than a block of 16
+  std::string body;
+  std::string expanded;
+  for (UINT i = 0; i < 100; ++i) {
+    body += (i % 40 < 20) ? ("N") : ("ACGT");
+    expanded += (i % 40 < 20) ? ("{ACGT}") : ("ACGT");
+  }
+  expect_same_parse(dna_parser, cDNAAlphabet.size(), body, expanded);
+
+  Parser prot_parser(AlphabetType::PROT, cPROTAlphabet);
+  expect_same_parse(prot_parser, cPROTAlphabet.size(), "MbXZ{JK}",
+                    "M{DN}{ACDEFGHIKLMNPQRSTVWY}{EQ}{ILK}");
+
+  // A symbol of one letter is still invalid; in the general alphabet the
+  // codes are letters
+  Degenerate_string dstr(cPROTAlphabet.size());
+  std::string invalid = "M{A}";
+  EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT,
+            prot_parser.parse_sequence(invalid.data(),
+                                       invalid.data() + invalid.size(), dstr));
+  Parser gen_parser(AlphabetType::GEN, cGENAlphabet);
+  Degenerate_string gen_dstr(cGENAlphabet.size());
+  std::string gen = "NX";
+  ASSERT_EQ(ReturnStatus::SUCCESS,
+            gen_parser.parse_sequence(gen.data(), gen.data() + gen.size(),
+                                      gen_dstr));
+  EXPECT_EQ((std::vector<ENCODED_CHAR>{14, 24}), gen_dstr.get_symbols());
+}
@@ -0,0 +1,116 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Mapped_file.hpp"
+#include "Parser.hpp"
+#include "Pipeline.hpp"
+#include "globalDefs.hpp"
+#include "gtest/gtest.h"
+
+using namespace deglpf;
+
+// Output of the pipeline without the lines of the execution times
+std::vector<std::string> run_pipeline(const std::string &input,
+                                      const PipelineOptions &options,
+                                      ReturnStatus &status,
+                                      const bool in_memory = false) {
+  std::string alphabet = "ACGTU";
+  Parser parser(AlphabetType::DNA, alphabet);
+  Pipeline pipeline(parser, alphabet.size(), SearchOptions(), options);
+  std::istringstream infile(input);
+  std::ostringstream outfile;
+  if (in_memory) {
+    status = pipeline.run(input.data(), input.data() + input.size(), outfile);
+  } else {
+    status = pipeline.run(infile, outfile);
+  }
+  std::vector<std::string> lines;
+  std::istringstream result(outfile.str());
+  std::string line;
+  bool time_line = false;
+  while (std::getline(result, line)) {
+    if (!time_line) {
+      lines.push_back(line);
+    }
+    time_line = (!line.empty() && line[0] == '>');
+  }
+  return lines;
+}
+
+TEST(pipelineTest, OrderedRecords) {
+  std::ifstream infile("test_files/testAlgo.txt");
+  std::string input((std::istreambuf_iterator<char>(infile)),
+                    std::istreambuf_iterator<char>());
+  // More records than the file has
+  for (UINT r = 0; r < 5; ++r) {
+    input += "\n> copy " + std::to_string(r) + "\nACC{A C}CC{G T}{AC}AAA\n";
+  }
+  ReturnStatus status;
+  auto expected = run_pipeline(input, PipelineOptions(), status);
+  EXPECT_EQ(ReturnStatus::SUCCESS, status);
+  EXPECT_EQ("> test seq", expected[0]);
+  EXPECT_EQ("11 3", expected[1]);
+  EXPECT_EQ("0 0 4 3 2 1 0 2 3 2 1 ", expected[2]);
+  EXPECT_EQ(4 * 12, expected.size());
+
+  PipelineOptions options;
+  options.num_workers = 4;
+  options.max_in_flight = 3;
+  EXPECT_EQ(expected, run_pipeline(input, options, status));
+  EXPECT_EQ(ReturnStatus::SUCCESS, status);
+  // Groups sharing one index (the last one smaller)
+  options.group_size = 5;
+  EXPECT_EQ(expected, run_pipeline(input, options, status));
+  EXPECT_EQ(ReturnStatus::SUCCESS, status);
+}
+
+TEST(pipelineTest, StopsAtInvalidRecord) {
+  std::string input = "> first\nACC{A C}CC\n\n> second\nACX\n\n> third\nAC\n";
+  PipelineOptions options;
+  options.num_workers = 3;
+  ReturnStatus status;
+  auto lines = run_pipeline(input, options, status);
+  EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT, status);
+  // Only the record before the invalid one is written
+  EXPECT_EQ(4, lines.size());
+  EXPECT_EQ("> first", lines[0]);
+}
+
+TEST(pipelineTest, InMemoryRecords) {
+  const std::vector<std::string> inputs = {
+      "> first\nACC{A C}CC\nGT\n\n\n> second\nA{CG}T\n",
+      "> first\nacgt\n  \n{AC}\n\n> second\nAC", // no newline at the end
+      "> first\nACC\n\nfirst\nAC\n",              // not a header
+      "> first\nACC\n\n> second\nACX\n",
+      "> only header",
+      "\n> empty first line\nAC\n",
+      ""};
+  for (const auto &input : inputs) {
+    for (UINT group_size : {1, 2}) {
+      PipelineOptions options;
+      options.num_workers = 2;
+      options.group_size = group_size;
+      ReturnStatus status;
+      ReturnStatus mapped_status;
+      auto lines = run_pipeline(input, options, status);
+      auto mapped_lines = run_pipeline(input, options, mapped_status, true);
+      EXPECT_EQ(status, mapped_status) << input;
+      EXPECT_EQ(lines, mapped_lines) << input;
+    }
+  }
+}
+
+TEST(pipelineTest, MappedFile) {
+  const std::string filename = "mapped_file_test.txt";
+  const std::string input = "> first\nACC{A C}CC\n";
+  {
+    std::ofstream file(filename);
+    file << input;
+  }
+  Mapped_file mapped_file;
+  ASSERT_EQ(ReturnStatus::SUCCESS, mapped_file.open(filename));
+  EXPECT_EQ(input, std::string(mapped_file.begin(), mapped_file.end()));
+  std::remove(filename.c_str());
+  EXPECT_EQ(ReturnStatus::ERR_FILE_OPEN, Mapped_file().open(filename));
+}
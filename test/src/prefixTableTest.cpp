@@ -0,0 +1,48 @@
+#include "Prefix_table.hpp"
+#include "globalDefs.hpp"
+#include "gtest/gtest.h"
+#include <limits.h>
+#include <vector>
+
+using namespace deglpf;
+
+TEST(prefixTableTest, NarrowestWidth) {
+  EXPECT_EQ(8, Prefix_table(2, 3, 254).get_width());
+  EXPECT_EQ(16, Prefix_table(2, 3, 255).get_width());
+  EXPECT_EQ(16, Prefix_table(2, 3, 65534).get_width());
+  EXPECT_EQ(32, Prefix_table(2, 3, 65535).get_width());
+}
+
+void fill_cells(const TableLayout layout) {
+  const UINT rows = 3;
+  const UINT cols = 11;
+  Prefix_table table(rows, cols, 300, layout);
+  for (UINT r = 0; r < rows; ++r) {
+    for (UINT c = 0; c < cols; ++c) {
+      EXPECT_EQ(-1, table.get(r, c));
+    }
+  }
+  for (UINT r = 0; r < rows; ++r) {
+    for (UINT c = 0; c < cols; c += 2) {
+      table.set(r, c, (r * cols + c) % 301);
+    }
+  }
+  table.set(1, 4, (1 * cols + 4) % 301); // same value again
+  table.set(2, 9, 0);                    // overwrite nothing but the sentinel
+  for (UINT r = 0; r < rows; ++r) {
+    for (UINT c = 0; c < cols; ++c) {
+      if (c % 2 == 0) {
+        EXPECT_EQ((r * cols + c) % 301, table.get(r, c));
+      } else if (r == 2 && c == 9) {
+        EXPECT_EQ(0, table.get(r, c));
+      } else {
+        EXPECT_EQ(-1, table.get(r, c));
+      }
+    }
+  }
+}
+
+TEST(prefixTableTest, FillCells) {
+  fill_cells(TableLayout::SYMBOL_MAJOR);
+  fill_cells(TableLayout::POSITION_MAJOR);
+}
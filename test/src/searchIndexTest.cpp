@@ -0,0 +1,73 @@
+#include "Search_index.hpp"
+#include "Suffix_array.hpp"
+#include "globalDefs.hpp"
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <limits.h>
+#include <vector>
+
+using namespace deglpf;
+
+void expect_lce(const IndexProfile profile, const UINT num_threads) {
+  // Periodic with distinct delimiters, as a solid sequence
+  const std::vector<UINT> text = {1, 2, 1, 2, 1, 7, 1, 2, 1, 2, 3, 8,
+                                  1, 2, 1, 2, 1, 2, 3, 1, 2, 4, 2, 1};
+  const UINT n = text.size();
+  sdsl::int_vector<> seq(n, 0, 4);
+  for (UINT i = 0; i < n; ++i) {
+    seq[i] = text[i];
+  }
+  std::unique_ptr<Search_index> index = make_search_index(profile);
+  index->build(seq, num_threads);
+  for (UINT i = 0; i < n; ++i) {
+    EXPECT_EQ(i, index->sa(index->isa(i)));
+  }
+  for (UINT i = 0; i < n; ++i) {
+    for (UINT j = 0; j < n; ++j) {
+      if (i == j) {
+        continue;
+      }
+      UINT l = 0;
+      while (i + l < n && j + l < n && text[i + l] == text[j + l]) {
+        ++l;
+      }
+      EXPECT_EQ(l, index->lce(i, j));
+    }
+  }
+}
+
+TEST(searchIndexTest, SuccinctLce) { expect_lce(IndexProfile::SUCCINCT, 1); }
+
+TEST(searchIndexTest, FastLce) { expect_lce(IndexProfile::FAST, 1); }
+
+TEST(searchIndexTest, CompactLce) { expect_lce(IndexProfile::COMPACT, 1); }
+
+TEST(searchIndexTest, ParallelLce) {
+  expect_lce(IndexProfile::SUCCINCT, 4);
+  expect_lce(IndexProfile::FAST, 4);
+  expect_lce(IndexProfile::COMPACT, 3);
+}
+
+TEST(searchIndexTest, ParallelSuffixArray) {
+  // Random over a small alphabet (long repeats), as the sequences of SDSL
+  std::srand(7);
+  const UINT n = 5000;
+  sdsl::int_vector<> seq(n, 0, 3);
+  for (UINT i = 0; i < n; ++i) {
+    seq[i] = 1 + std::rand() % ((i < n / 2) ? (2) : (4));
+  }
+  std::vector<uint32_t> sa;
+  std::vector<uint32_t> lcp;
+  construct_suffix_array(seq, 4, sa);
+  construct_lcp_array(seq, sa, 4, lcp);
+  sdsl::csa_bitcompressed<sdsl::int_alphabet<>> csa;
+  sdsl::lcp_bitcompressed<> expected_lcp;
+  construct_im(csa, seq, 0);
+  construct_im(expected_lcp, seq, 0);
+  ASSERT_EQ(csa.size(), sa.size());
+  ASSERT_EQ(expected_lcp.size(), lcp.size());
+  for (UINT j = 0; j < sa.size(); ++j) {
+    EXPECT_EQ(csa[j], sa[j]);
+    EXPECT_EQ(expected_lcp[j], lcp[j]);
+  }
+}
@@ -2,10 +2,13 @@
 #include <vector>
 #include <string>
 #include <iterator>
+#include <memory>
+#include <sstream>
 #include "Parser.hpp"
 #include "globalDefs.hpp"
 #include "Degenerate_string.hpp"
 #include "Search.hpp"
+#include "Shared_index.hpp"
 #include "gtest/gtest.h"
 
 
@@ -23,7 +26,7 @@ const std::vector<std::vector<UINT>> lpf = {
   {0,1,1,5,4,3,2,3,2,1},
   {0, 0, 5, 6, 5, 4, 3, 2, 2, 1 }
 };
-TEST(alsoTest, MultipleSimpleSeq) {
+std::vector<std::vector<UINT>> calculate_all(const SearchOptions &options) {
   std::vector<std::vector<UINT>> result;
   std::string alphabet = "ACGTU";
   Parser parser(AlphabetType::DNA, alphabet);
@@ -37,13 +40,16 @@ TEST(alsoTest, MultipleSimpleSeq) {
       parser.parse_sequence(infile, dgs);
       UINT seq_size = dgs.get_size();
       std::vector<UINT> lpf(seq_size, 0);
-      Search search(dgs);
+      Search search(dgs, options);
       search.calculate_lpf(lpf);
       result.push_back(lpf);
     }
   } while (std::getline(infile, line)); // file ends
+  return result;
+}
 
-
+void expect_lpf(const std::vector<std::vector<UINT>> &result) {
+  ASSERT_EQ(lpf.size(), result.size());
   for (int i=0; i < lpf.size(); ++i) {
     EXPECT_EQ(lpf[i].size(), result[i].size());
     for (auto j = 0; j < lpf[i].size(); ++j) {
@@ -52,4 +58,251 @@ TEST(alsoTest, MultipleSimpleSeq) {
    } 
 }
 
+TEST(alsoTest, MultipleSimpleSeq) {
+  expect_lpf(calculate_all(SearchOptions()));
+}
+
+TEST(alsoTest, MultipleSimpleSeqParallel) {
+  SearchOptions options;
+  options.num_threads = 4;
+  expect_lpf(calculate_all(options));
+}
+
+TEST(alsoTest, MultipleSimpleSeqDiagonalFill) {
+  SearchOptions options;
+  options.fill_type = FillType::DIAGONALS;
+  expect_lpf(calculate_all(options));
+  options.num_threads = 4;
+  expect_lpf(calculate_all(options));
+}
+
+TEST(alsoTest, MultipleSimpleSeqLazyFill) {
+  SearchOptions options;
+  options.fill_type = FillType::LAZY;
+  expect_lpf(calculate_all(options));
+  options.num_threads = 4;
+  expect_lpf(calculate_all(options));
+}
+
+TEST(alsoTest, LazyFillFillsFewerCells) {
+  std::string alphabet = "ACGTU";
+  Parser parser(AlphabetType::DNA, alphabet);
+  std::string input;
+  for (UINT i = 0; i < 2000; ++i) {
+    input += (i % 97 == 50) ? ("{A C}") : (std::string(1, "ACGT"[(i * i * 7 + i / 3) % 4]));
+  }
+  Degenerate_string dgs(alphabet.size());
+  std::istringstream seq_stream(input + "\n");
+  parser.parse_sequence(seq_stream, dgs);
+  SearchOptions options;
+  std::vector<UINT> rows_lpf(dgs.get_size(), 0);
+  Search rows_search(dgs, options);
+  rows_search.calculate_lpf(rows_lpf);
+  options.fill_type = FillType::LAZY;
+  std::vector<UINT> lazy_lpf(dgs.get_size(), 0);
+  Search lazy_search(dgs, options);
+  lazy_search.calculate_lpf(lazy_lpf);
+  EXPECT_EQ(rows_lpf, lazy_lpf);
+  // Only the cells of chains are stored, against all the cells
+  auto rows_cells = rows_search.get_chain_stats().num_cells;
+  auto lazy_cells = lazy_search.get_chain_stats().num_cells;
+  EXPECT_GE(rows_cells, (dgs.get_numberof_seeds() - 1) * dgs.get_size() / 2);
+  EXPECT_LT(lazy_cells * 5, rows_cells);
+}
+
+TEST(alsoTest, MultipleSimpleSeqPositionMajor) {
+  SearchOptions options;
+  options.table_layout = TableLayout::POSITION_MAJOR;
+  expect_lpf(calculate_all(options));
+  options.fill_type = FillType::DIAGONALS;
+  options.num_threads = 4;
+  expect_lpf(calculate_all(options));
+}
+
+TEST(alsoTest, MoreDegenerateSymbolsThanBytes) {
+  // More degenerate symbols than fit in a one byte alphabet
+  const UINT num_symbols = 300;
+  Degenerate_string dgs(cDNAAlphabet.size());
+  for (UINT s = 0; s < num_symbols; ++s) {
+    dgs.add_seed(SEED{1, 2});
+    dgs.add_degenerate_symbol(std::vector<ENCODED_CHAR>{1, 3});
+  }
+  dgs.add_seed(SEED{1, 2});
+  std::vector<UINT> lpf(dgs.get_size(), 0);
+  Search search(dgs);
+  search.calculate_lpf(lpf);
+  EXPECT_TRUE(search.naive_test(lpf));
+  EXPECT_EQ(0, lpf[0]);
+  EXPECT_EQ(dgs.get_size() - 3, lpf[3]);
+}
+
+TEST(alsoTest, MultipleSimpleSeqIndexProfiles) {
+  SearchOptions options;
+  options.index_profile = IndexProfile::FAST;
+  expect_lpf(calculate_all(options));
+  options.index_profile = IndexProfile::COMPACT;
+  expect_lpf(calculate_all(options));
+}
+
+TEST(alsoTest, LongRepeats) {
+  // Matches much longer than the symbols compared directly
+  Degenerate_string dgs(cDNAAlphabet.size());
+  SEED seed;
+  for (UINT r = 0; r < 30; ++r) {
+    seed.insert(seed.end(), {1, 2, 3});
+  }
+  dgs.add_seed(seed);
+  dgs.add_degenerate_symbol(std::vector<ENCODED_CHAR>{1, 4});
+  dgs.add_seed(seed);
+  dgs.add_degenerate_symbol(std::vector<ENCODED_CHAR>{2, 3});
+  seed.push_back(4);
+  dgs.add_seed(seed);
+  const UINT n = dgs.get_size();
+  SearchOptions options;
+  for (auto l_region_search : {LRegionSearch::SCAN, LRegionSearch::BORDERS}) {
+    options.l_region_search = l_region_search;
+    std::vector<UINT> lpf(n, 0);
+    Search search(dgs, options);
+    search.calculate_lpf(lpf);
+    // Compare with the symbol by symbol matches
+    for (UINT i = 0; i < n; ++i) {
+      UINT longest = 0;
+      for (UINT j = 0; j < i; ++j) {
+        UINT l = 0;
+        while (i + l < n && dgs.is_match(i + l, j + l)) {
+          ++l;
+        }
+        longest = std::max(longest, l);
+      }
+      EXPECT_EQ(longest, lpf[i]);
+    }
+  }
+}
+
+TEST(alsoTest, LongChains) {
+  // A run of compatible degenerate symbols chains the cells of the table
+  Degenerate_string dgs(cDNAAlphabet.size());
+  for (UINT r = 0; r < 200; ++r) {
+    dgs.add_seed(SEED{1});
+    dgs.add_degenerate_symbol(std::vector<ENCODED_CHAR>{1, 2});
+  }
+  dgs.add_seed(SEED{3});
+  const UINT n = dgs.get_size();
+  SearchOptions options;
+  for (auto fill_type : {FillType::ROWS, FillType::LAZY}) {
+    options.fill_type = fill_type;
+    options.num_threads = (fill_type == FillType::LAZY) ? (4) : (1);
+    std::vector<UINT> lpf(n, 0);
+    Search search(dgs, options);
+    search.calculate_lpf(lpf);
+    for (UINT i = 0; i < n; ++i) {
+      UINT longest = 0;
+      for (UINT j = 0; j < i; ++j) {
+        UINT l = 0;
+        while (i + l < n && dgs.is_match(i + l, j + l)) {
+          ++l;
+        }
+        longest = std::max(longest, l);
+      }
+      EXPECT_EQ(longest, lpf[i]);
+    }
+    auto stats = search.get_chain_stats();
+    EXPECT_GT(stats.longest, 100);
+    EXPECT_GE(stats.num_cells, stats.num_chains);
+  }
+}
+
+TEST(alsoTest, MultipleSimpleSeqZArray) {
+  SearchOptions options;
+  options.backward_lce = BackwardLce::Z_ARRAY;
+  expect_lpf(calculate_all(options));
+  options.num_threads = 4;
+  options.fill_type = FillType::LAZY;
+  expect_lpf(calculate_all(options));
+}
+
+TEST(alsoTest, MultipleSimpleSeqBorders) {
+  SearchOptions options;
+  options.l_region_search = LRegionSearch::BORDERS;
+  expect_lpf(calculate_all(options));
+  options.num_threads = 4;
+  expect_lpf(calculate_all(options));
+}
+
+// LPF-array of each string by symbol by symbol matches
+std::vector<UINT> brute_force_lpf(const Degenerate_string &dgs) {
+  const UINT n = dgs.get_size();
+  std::vector<UINT> result(n, 0);
+  for (UINT i = 0; i < n; ++i) {
+    for (UINT j = 0; j < i; ++j) {
+      UINT l = 0;
+      while (i + l < n && dgs.is_match(i + l, j + l)) {
+        ++l;
+      }
+      result[i] = std::max(result[i], l);
+    }
+  }
+  return result;
+}
 
+TEST(alsoTest, SharedIndex) {
+  std::string alphabet = "ACGTU";
+  Parser parser(AlphabetType::DNA, alphabet);
+  // The strings repeat each other; a match must not reach an earlier string
+  std::vector<std::string> inputs = {"AAAA", "ACC{A C}CC{G T}{AC}AAA",
+                                     "AAAA{A C}A", "ACC{A C}CC{G T}{AC}AAA",
+                                     "{AC}"};
+  std::vector<std::unique_ptr<Degenerate_string>> strings;
+  std::vector<const Degenerate_string *> string_ptrs;
+  for (auto &input : inputs) {
+    strings.emplace_back(new Degenerate_string(alphabet.size()));
+    std::istringstream seq_stream(input);
+    parser.parse_sequence(seq_stream, *strings.back());
+    string_ptrs.push_back(strings.back().get());
+  }
+  SearchOptions options;
+  for (auto backward_lce : {BackwardLce::REVERSE_INDEX, BackwardLce::Z_ARRAY}) {
+    options.backward_lce = backward_lce;
+    Shared_index shared_index(string_ptrs, options);
+    for (UINT s = 0; s < strings.size(); ++s) {
+      std::vector<UINT> lpf(strings[s]->get_size(), 0);
+      Search search(*strings[s], shared_index, s, options);
+      search.calculate_lpf(lpf);
+      EXPECT_EQ(brute_force_lpf(*strings[s]), lpf);
+      std::vector<UINT> own_lpf(strings[s]->get_size(), 0);
+      Search own_search(*strings[s], options);
+      own_search.calculate_lpf(own_lpf);
+      EXPECT_EQ(own_lpf, lpf);
+    }
+  }
+}
+
+TEST(alsoTest, IrreducibleLpf) {
+  std::string alphabet = "ACGTU";
+  Parser parser(AlphabetType::DNA, alphabet);
+  // A repetitive sequence: the LPF-array is made of long decreasing runs
+  std::string input;
+  for (UINT r = 0; r < 40; ++r) {
+    input += (r % 7 == 3) ? ("ACG{A T}TTAC") : ("ACGATTACGG");
+  }
+  Degenerate_string dgs(alphabet.size());
+  std::istringstream seq_stream(input + "\n");
+  parser.parse_sequence(seq_stream, dgs);
+  for (auto l_region_search : {LRegionSearch::SCAN, LRegionSearch::BORDERS}) {
+    SearchOptions options;
+    options.l_region_search = l_region_search;
+    std::vector<UINT> lpf(dgs.get_size(), 0);
+    Search search(dgs, options);
+    search.calculate_lpf(lpf);
+    Irreducible_lpf irreducible_lpf;
+    Search irreducible_search(dgs, options);
+    irreducible_search.calculate_lpf(irreducible_lpf);
+    ASSERT_EQ(lpf.size(), irreducible_lpf.size());
+    for (UINT i = 0; i < lpf.size(); ++i) {
+      EXPECT_EQ(lpf[i], irreducible_lpf[i]);
+    }
+    EXPECT_EQ(Irreducible_lpf(lpf).get_numberof_irreducible(),
+              irreducible_lpf.get_numberof_irreducible());
+    EXPECT_LT(irreducible_lpf.get_numberof_irreducible() * 10, lpf.size());
+  }
+}
@@ -0,0 +1,96 @@
+#include "Degenerate_string.hpp"
+#include "Parser.hpp"
+#include "Variant_sites.hpp"
+#include "globalDefs.hpp"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace deglpf;
+
+const std::string vcf =
+    "##fileformat=VCFv4.2\n"
+    "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n"
+    "chr1\t2\t.\tC\tT\t.\tPASS\t.\n"
+    "chr1\t5\trs1\tG\tA,T\t.\tPASS\t.\n"  // multiallelic
+    "chr1\t7\t.\tAC\tA\t.\tPASS\t.\n"     // indel
+    "chr1\t9\t.\tT\t<DEL>,*\t.\tPASS\t.\n" // no SNP
+    "chr1\t4\t.\tA\tG\t.\tPASS\t.\n"      // out of order
+    "chr1\t5\t.\tG\tC\t.\tPASS\t.\n"      // same position
+    "chr2\t1\t.\tA\tC\r\n"                // fewer fields
+    "chr2\t3\t.\tN\tA\t.\tPASS\t.";       // no newline at the end
+
+// Writes the file (compressed with gzip if asked)
+void write_file(const std::string &filename, const std::string &content,
+                const bool compress) {
+  if (compress) {
+    gzFile file = gzopen(filename.c_str(), "wb");
+    gzwrite(file, content.data(), content.size());
+    gzclose(file);
+  } else {
+    std::ofstream file(filename);
+    file << content;
+  }
+}
+
+TEST(variantSitesTest, ReadVcf) {
+  Parser parser(AlphabetType::DNA, cDNAAlphabet);
+  for (bool compress : {false, true}) {
+    const std::string filename = "variant_sites_test.vcf";
+    write_file(filename, vcf, compress);
+    Variant_sites sites;
+    ASSERT_EQ(ReturnStatus::SUCCESS, sites.read_vcf(filename, parser));
+    std::remove(filename.c_str());
+    EXPECT_EQ(5, sites.get_numberof_sites());
+    // Letters: A 1, C 2, G 3, T 4
+    const std::vector<Variant_site> *chr1 = sites.get_sites("chr1");
+    ASSERT_NE(nullptr, chr1);
+    ASSERT_EQ(3, chr1->size());
+    EXPECT_EQ(1, (*chr1)[0].pos);
+    EXPECT_EQ((1u << 2) | (1u << 4), (*chr1)[0].mask);
+    EXPECT_EQ(3, (*chr1)[1].pos);
+    EXPECT_EQ(4, (*chr1)[2].pos);
+    EXPECT_EQ((1u << 1) | (1u << 2) | (1u << 3) | (1u << 4), (*chr1)[2].mask);
+    EXPECT_EQ(chr1, sites.get_sites_of_record(" chr1 first chromosome"));
+    ASSERT_NE(nullptr, sites.get_sites("chr2"));
+    EXPECT_EQ(2, sites.get_sites("chr2")->size());
+    EXPECT_EQ(nullptr, sites.get_sites("chr3"));
+  }
+  Variant_sites sites;
+  EXPECT_EQ(ReturnStatus::ERR_FILE_OPEN,
+            sites.read_vcf("no_such_file.vcf", parser));
+  write_file("invalid.vcf", "chr1\t2\t.\tC\n", false);
+  EXPECT_EQ(ReturnStatus::ERR_INVALID_INPUT,
+            sites.read_vcf("invalid.vcf", parser));
+  std::remove("invalid.vcf");
+}
+
+TEST(variantSitesTest, ParseWithSites) {
+  Parser parser(AlphabetType::DNA, cDNAAlphabet);
+  // Sites in runs of letters, at the start, at an ambiguity code, in braces
+  // and after a newline
+  std::vector<Variant_site> sites = {
+      {0, 1u << 3}, {2, 1u << 1}, {5, 1u << 3}, {6, 1u << 4}, {8, 1u << 1},
+      {19, 1u << 4}};
+  std::string body = "ACGTN{AC}\nAACCGGTTAACCGGTTA\n";
+  std::string expanded = "{AG}C{AG}T{ACGT}{ACG}{AT}A{AC}CGGTTAACCG{GT}TTA";
+  for (UINT i = 0; i < 2; ++i) {
+    Degenerate_string dstr(cDNAAlphabet.size());
+    Degenerate_string expected(cDNAAlphabet.size());
+    ASSERT_EQ(ReturnStatus::SUCCESS,
+              parser.parse_sequence(body.data(), body.data() + body.size(),
+                                    dstr, &sites));
+    ASSERT_EQ(ReturnStatus::SUCCESS,
+              parser.parse_sequence(expanded.data(),
+                                    expanded.data() + expanded.size(),
+                                    expected));
+    EXPECT_EQ(expected.get_symbols(), dstr.get_symbols());
+    EXPECT_EQ(expected.get_seed_offsets(), dstr.get_seed_offsets());
+    EXPECT_EQ(expected.get_degenerate_symbols(),
+              dstr.get_degenerate_symbols());
+    // A site beyond the end is left out
+    sites.push_back({100, 1u << 1});
+  }
+}